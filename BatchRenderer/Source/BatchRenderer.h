@@ -0,0 +1,226 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "../../Source/PluginProcessor.h"
+
+#include <iostream>
+
+namespace Batch
+{
+    using namespace juce;
+
+    struct Settings
+    {
+        //a getStateInformation() blob, every processor is restored from it
+        MemoryBlock state;
+
+        File outputDirectory;
+        String outputExtension = ".wav";
+
+        //0 keeps the input's bit depth when the output format supports it
+        int bitDepth = 0;
+
+        int blockSize = 8192;
+        int numThreads = 1;
+    };
+
+    //the state to render with, from a getStateInformation() blob or the XML of apvts.state
+    inline bool loadState(const File& file, MemoryBlock& state)
+    {
+        if (auto xml = parseXML(file))
+        {
+            const auto tree = ValueTree::fromXml(*xml);
+            if (!tree.isValid())
+                return false;
+
+            state.reset();
+            MemoryOutputStream stream(state, false);
+            tree.writeToStream(stream);
+            return true;
+        }
+
+        return file.loadFileAsData(state) && state.getSize() > 0;
+    }
+
+    /*
+     renders audio files through the processor. there is one processor per
+     worker thread, each one takes the next file in the list until there are
+     none left. files are streamed block by block from the reader to the
+     writer, so memory use doesn't depend on how long they are.
+     */
+    class Renderer
+    {
+    public:
+        explicit Renderer(const Settings& settingsToUse) : settings(settingsToUse)
+        {
+            formatManager.registerBasicFormats();
+        }
+
+        //returns the number of files that failed
+        int render(const Array<File>& inputs)
+        {
+            files = inputs;
+            nextFile = 0;
+            numFailed = 0;
+
+            const auto numWorkers = jlimit(1, jmax(1, files.size()), settings.numThreads);
+
+            //processors are made and restored here, the workers only prepare and run them
+            OwnedArray<CourseworkPluginAudioProcessor> processors;
+            for (int i = 0; i < numWorkers; ++i)
+            {
+                auto* processor = processors.add(new CourseworkPluginAudioProcessor());
+                processor->setNonRealtime(true);
+                processor->setPlayConfigDetails(2, 2, 44100.0, settings.blockSize);
+                processor->setStateInformation(settings.state.getData(), (int)settings.state.getSize());
+            }
+
+            ThreadPool pool(numWorkers);
+            for (auto* processor : processors)
+                pool.addJob(new Worker(*this, *processor), true);
+
+            while (pool.getNumJobs() > 0)
+                Thread::sleep(50);
+
+            return numFailed;
+        }
+    private:
+        class Worker : public ThreadPoolJob
+        {
+        public:
+            Worker(Renderer& ownerToUse, CourseworkPluginAudioProcessor& processorToUse)
+                : ThreadPoolJob("render"), owner(ownerToUse), processor(processorToUse) {}
+
+            JobStatus runJob() override
+            {
+                while (!shouldExit())
+                {
+                    const auto index = owner.nextFile++;
+                    if (index >= owner.files.size())
+                        break;
+
+                    owner.renderFile(processor, owner.files[index]);
+                }
+
+                return jobHasFinished;
+            }
+        private:
+            Renderer& owner;
+            CourseworkPluginAudioProcessor& processor;
+        };
+
+        Settings settings;
+        AudioFormatManager formatManager;
+
+        Array<File> files;
+        std::atomic<int> nextFile{ 0 };
+        std::atomic<int> numFailed{ 0 };
+
+        CriticalSection outputLock;
+
+        void report(const String& message)
+        {
+            const ScopedLock lock(outputLock);
+            std::cout << message << std::endl;
+        }
+
+        //partialOutput is deleted, its writer has to be closed by now
+        void fail(const File& input, const String& reason, const File& partialOutput = {})
+        {
+            ++numFailed;
+
+            if (partialOutput != File())
+                partialOutput.deleteFile();
+
+            const ScopedLock lock(outputLock);
+            std::cerr << "FAILED " << input.getFullPathName() << ": " << reason << std::endl;
+        }
+
+        int chooseBitDepth(AudioFormat& format, int inputBitDepth) const
+        {
+            const auto depths = format.getPossibleBitDepths();
+            const auto wanted = settings.bitDepth > 0 ? settings.bitDepth : inputBitDepth;
+
+            if (depths.contains(wanted))
+                return wanted;
+
+            return depths.contains(24) ? 24 : depths.getLast();
+        }
+
+        void renderFile(CourseworkPluginAudioProcessor& processor, const File& input)
+        {
+            const auto startTime = Time::getMillisecondCounterHiRes();
+
+            std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(input));
+            if (reader == nullptr)
+                return fail(input, "unsupported or unreadable file");
+
+            const auto numChannels = (int)reader->numChannels;
+            if (numChannels < 1 || numChannels > 2)
+                return fail(input, "only mono and stereo files can be rendered");
+
+            const auto output = settings.outputDirectory.getChildFile(input.getFileNameWithoutExtension() + settings.outputExtension);
+            if (output == input)
+                return fail(input, "the output would overwrite the input");
+
+            auto* format = formatManager.findFormatForFileExtension(settings.outputExtension);
+            if (format == nullptr)
+                return fail(input, "no writer for " + settings.outputExtension);
+
+            output.deleteFile();
+            auto stream = output.createOutputStream();
+            if (stream == nullptr)
+                return fail(input, "couldn't create " + output.getFullPathName());
+
+            std::unique_ptr<AudioFormatWriter> writer(format->createWriterFor(stream.get(), reader->sampleRate, (unsigned int)numChannels,
+                chooseBitDepth(*format, (int)reader->bitsPerSample), reader->metadataValues, 0));
+
+            if (writer == nullptr)
+            {
+                stream.reset();
+                return fail(input, "couldn't write " + format->getFormatName() + " at this rate and depth", output);
+            }
+
+            //the writer owns the stream now
+            stream.release();
+
+            //every file starts from the same state, prepareToPlay clears the filters
+            processor.setPlayConfigDetails(2, 2, reader->sampleRate, settings.blockSize);
+            processor.prepareToPlay(reader->sampleRate, settings.blockSize);
+
+            AudioBuffer<float> buffer(2, settings.blockSize);
+            MidiBuffer midi;
+
+            for (int64 position = 0; position < reader->lengthInSamples; position += settings.blockSize)
+            {
+                const auto numSamples = (int)jmin((int64)settings.blockSize, reader->lengthInSamples - position);
+                buffer.setSize(2, numSamples, false, false, true);
+
+                reader->read(&buffer, 0, numSamples, position, true, true);
+
+                //mono files are processed as dual mono and written back as mono
+                if (numChannels == 1)
+                    buffer.copyFrom(1, 0, buffer, 0, 0, numSamples);
+
+                processor.processBlock(buffer, midi);
+
+                if (!writer->writeFromAudioSampleBuffer(buffer, 0, numSamples))
+                {
+                    processor.releaseResources();
+                    writer.reset();
+                    return fail(input, "write error", output);
+                }
+            }
+
+            processor.releaseResources();
+            writer.reset();
+
+            const auto seconds = (Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+            const auto audioSeconds = reader->sampleRate > 0.0 ? reader->lengthInSamples / reader->sampleRate : 0.0;
+
+            report(input.getFileName() + " -> " + output.getFullPathName()
+                + "  (" + String(seconds, 2) + " s, " + String(seconds > 0.0 ? audioSeconds / seconds : 0.0, 1) + "x realtime)");
+        }
+    };
+};
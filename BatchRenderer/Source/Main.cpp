@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    renders audio files through the plugin without a host.
+
+    usage: BatchRenderer --state preset.xml --output-dir out [--format wav|flac]
+                         [--bits N] [--block-size N] [--threads N] inputs...
+
+    --state is a blob saved with getStateInformation(), or the XML of the
+    parameter state. inputs can be files or folders, folders are searched
+    for wav, flac and aiff files. the exit code is the number of files that
+    failed, inputs skipped because another has the same name count as failed.
+
+  ==============================================================================
+*/
+
+#include "BatchRenderer.h"
+
+int main (int argc, char* argv[])
+{
+    using namespace juce;
+
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    ArgumentList args(argc, argv);
+
+    if (!args.containsOption("--state") || !args.containsOption("--output-dir"))
+    {
+        std::cerr << "usage: BatchRenderer --state preset.xml --output-dir out [--format wav|flac] "
+                     "[--bits N] [--block-size N] [--threads N] inputs..." << std::endl;
+        return 1;
+    }
+
+    Batch::Settings settings;
+
+    const auto stateFile = args.getFileForOption("--state");
+    if (!Batch::loadState(stateFile, settings.state))
+    {
+        std::cerr << "couldn't load a state from " << stateFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    settings.outputDirectory = args.getFileForOption("--output-dir");
+    if (!settings.outputDirectory.createDirectory())
+    {
+        std::cerr << "couldn't create " << settings.outputDirectory.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    if (args.containsOption("--format"))
+        settings.outputExtension = "." + args.getValueForOption("--format").trimCharactersAtStart(".").toLowerCase();
+
+    if (args.containsOption("--bits"))
+        settings.bitDepth = args.getValueForOption("--bits").getIntValue();
+
+    if (args.containsOption("--block-size"))
+        settings.blockSize = jlimit(32, 65536, args.getValueForOption("--block-size").getIntValue());
+
+    settings.numThreads = args.containsOption("--threads")
+        ? jmax(1, args.getValueForOption("--threads").getIntValue())
+        : SystemStats::getNumCpus();
+
+    //everything that isn't an option or an option's value is an input
+    const StringArray valueOptions{ "--state", "--output-dir", "--format", "--bits", "--block-size", "--threads" };
+    Array<File> inputs;
+    StringArray outputNames;
+    int numSkipped = 0;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const auto& arg = args[i];
+
+        if (arg.isOption())
+        {
+            if (!arg.text.containsChar('=') && valueOptions.contains(arg.text))
+                ++i;
+
+            continue;
+        }
+
+        const auto file = arg.resolveAsFile();
+        Array<File> found;
+
+        if (file.isDirectory())
+            found = file.findChildFiles(File::findFiles, true, "*.wav;*.flac;*.aif;*.aiff");
+        else
+            found.add(file);
+
+        //files with the same name would be written to the same output
+        for (const auto& input : found)
+        {
+            const auto name = input.getFileNameWithoutExtension();
+            if (outputNames.contains(name, true))
+            {
+                std::cerr << "FAILED " << input.getFullPathName() << ": another input has the same name" << std::endl;
+                ++numSkipped;
+                continue;
+            }
+
+            outputNames.add(name);
+            inputs.add(input);
+        }
+    }
+
+    if (inputs.isEmpty())
+    {
+        std::cerr << "no input files" << std::endl;
+        return jmax(1, numSkipped);
+    }
+
+    Batch::Renderer renderer(settings);
+    const auto numFailed = renderer.render(inputs) + numSkipped;
+    const auto numFiles = inputs.size() + numSkipped;
+
+    std::cout << (numFiles - numFailed) << " of " << numFiles << " files rendered" << std::endl;
+    return numFailed;
+}
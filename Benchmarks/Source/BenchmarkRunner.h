@@ -0,0 +1,171 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+
+namespace Bench
+{
+    using namespace juce;
+    using Clock = std::chrono::steady_clock;
+
+    inline double nanosecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    //one timed run: how long it took and how many samples or calls it covered
+    struct Run
+    {
+        double nanoseconds = 0.0;
+        int64 units = 0;
+    };
+
+    struct Result
+    {
+        String id;              //unique, used to match against a baseline
+        String unit;            //"ns/sample" or "ns/call"
+        NamedValueSet params;
+        double median = 0.0;
+        double minimum = 0.0;
+        int repetitions = 0;
+    };
+
+    /*
+     runs benchmarks, keeps their results and writes them out as JSON.
+     every benchmark gets a warm up run that isn't counted, then the median and
+     minimum of the timed runs are kept, the median is what baselines compare.
+     */
+    class Runner
+    {
+    public:
+        Runner(const StringArray& filtersToUse, int repetitionsToUse, double secondsPerRunToUse)
+            : filters(filtersToUse), repetitions(jmax(1, repetitionsToUse)), secondsPerRun(secondsPerRunToUse) {}
+
+        double getSecondsPerRun() const { return secondsPerRun; }
+
+        //false if a --filter was given and the id doesn't contain any of them
+        bool shouldRun(const String& id) const
+        {
+            if (filters.isEmpty())
+                return true;
+
+            for (const auto& filter : filters)
+                if (id.containsIgnoreCase(filter))
+                    return true;
+
+            return false;
+        }
+
+        //runOnce does one timed run and returns a Run
+        template<typename RunFunction>
+        void measure(const String& id, const String& unit, const NamedValueSet& params, RunFunction&& runOnce)
+        {
+            if (!shouldRun(id))
+                return;
+
+            runOnce();
+
+            std::vector<double> perUnit;
+            for (int i = 0; i < repetitions; ++i)
+            {
+                const Run run = runOnce();
+                perUnit.push_back(run.nanoseconds / double(jmax((int64)1, run.units)));
+            }
+
+            std::sort(perUnit.begin(), perUnit.end());
+
+            Result result;
+            result.id = id;
+            result.unit = unit;
+            result.params = params;
+            result.median = perUnit[perUnit.size() / 2];
+            result.minimum = perUnit.front();
+            result.repetitions = repetitions;
+
+            std::cerr << id << "  " << String(result.median, 2) << " " << unit << std::endl;
+            results.push_back(result);
+        }
+
+        const std::vector<Result>& getResults() const { return results; }
+
+        var toJson() const
+        {
+            auto* root = new DynamicObject();
+
+            auto* machine = new DynamicObject();
+            machine->setProperty("cpu", SystemStats::getCpuModel());
+            machine->setProperty("cores", SystemStats::getNumPhysicalCpus());
+            machine->setProperty("os", SystemStats::getOperatingSystemName());
+            machine->setProperty("juce", SystemStats::getJUCEVersion());
+           #if JUCE_DEBUG
+            machine->setProperty("build", "debug");
+           #else
+            machine->setProperty("build", "release");
+           #endif
+            root->setProperty("machine", var(machine));
+            root->setProperty("date", Time::getCurrentTime().toISO8601(true));
+
+            Array<var> list;
+            for (const auto& result : results)
+            {
+                auto* object = new DynamicObject();
+                object->setProperty("id", result.id);
+                object->setProperty("unit", result.unit);
+                object->setProperty("median", result.median);
+                object->setProperty("min", result.minimum);
+                object->setProperty("repetitions", result.repetitions);
+
+                auto* params = new DynamicObject();
+                for (const auto& param : result.params)
+                    params->setProperty(param.name, param.value);
+                object->setProperty("params", var(params));
+
+                list.add(var(object));
+            }
+            root->setProperty("results", list);
+
+            return var(root);
+        }
+
+        /*
+         compares the medians with a JSON file written by an earlier run and prints
+         every benchmark that got slower by more than tolerancePercent.
+         returns the number of regressions, benchmarks missing from either side are skipped
+         */
+        int compareWithBaseline(const var& baseline, double tolerancePercent) const
+        {
+            std::map<String, double> previous;
+            if (auto* list = baseline["results"].getArray())
+                for (const auto& entry : *list)
+                    previous[entry["id"].toString()] = (double)entry["median"];
+
+            int regressions = 0;
+            for (const auto& result : results)
+            {
+                const auto it = previous.find(result.id);
+                if (it == previous.end() || it->second <= 0.0)
+                    continue;
+
+                const auto change = 100.0 * (result.median / it->second - 1.0);
+                if (change > tolerancePercent)
+                {
+                    std::cerr << "REGRESSION " << result.id << "  " << String(it->second, 2) << " -> "
+                              << String(result.median, 2) << " " << result.unit << " (+" << String(change, 1) << "%)" << std::endl;
+                    ++regressions;
+                }
+            }
+
+            return regressions;
+        }
+    private:
+        StringArray filters;
+        int repetitions;
+        double secondsPerRun;
+
+        std::vector<Result> results;
+    };
+};
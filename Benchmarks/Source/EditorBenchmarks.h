@@ -0,0 +1,282 @@
+#pragma once
+
+#include "ProcessorBenchmarks.h"
+
+namespace Bench
+{
+    //an offscreen image at the physical size for a display scale, painted in logical coordinates
+    struct Canvas
+    {
+        Canvas(int width, int height, float scale)
+            : image(Image::ARGB, jmax(1, roundToInt(width * scale)), jmax(1, roundToInt(height * scale)), true),
+              graphics(image)
+        {
+            graphics.addTransform(AffineTransform::scale(scale));
+        }
+
+        Image image;
+        Graphics graphics;
+    };
+
+    /*
+     paints the editor into offscreen images, no display needed. the processor
+     runs on synthetic audio between frames so the analyser, waveform and meters
+     have moving data, the way they would with the editor open.
+     every layer the editor caches is timed on its own, both when it's rebuilt
+     and as part of a cached frame, in ns per frame at several sizes and scales
+     */
+    class EditorBenchmarks
+    {
+    public:
+        explicit EditorBenchmarks(Runner& runnerToUse) : runner(runnerToUse) {}
+
+        void run()
+        {
+            CourseworkPluginAudioProcessor processor;
+            prepare(processor, sampleRate, blockSize);
+
+            {
+                CourseworkPluginAudioProcessorEditor editor(processor);
+                const auto defaultSize = editor.getBounds();
+
+                for (auto scale : { 1.f, 1.5f, 2.f })
+                {
+                    //the layout stays centred, bigger windows only stretch the background
+                    for (auto halves : { 2, 3, 4 })
+                    {
+                        editor.setSize(defaultSize.getWidth() * halves / 2, defaultSize.getHeight() * halves / 2);
+                        runEditor(processor, editor, scale);
+                    }
+
+                    editor.setSize(defaultSize.getWidth(), defaultSize.getHeight());
+                    runControls(processor, editor, scale);
+
+                    auto& curve = editor.responseCurveComponent;
+                    const auto curveBounds = curve.getBounds();
+
+                    for (auto multiple : { 1, 2, 3 })
+                    {
+                        curve.setSize(curveBounds.getWidth() * multiple, curveBounds.getHeight() * multiple);
+                        runResponseCurve(processor, curve, scale);
+                    }
+
+                    curve.setBounds(curveBounds);
+                }
+            }
+
+            processor.releaseResources();
+        }
+    private:
+        static constexpr double sampleRate = 48000.0;
+        static constexpr int blockSize = 512;
+        static constexpr double frameRate = 60.0;
+
+        Runner& runner;
+
+        //synthetic input: a harmonic series with a slowly sweeping fundamental over noise
+        AudioBuffer<float> input{ 2, blockSize };
+        Random random{ 5 };
+        double time = 0.0;
+        MidiBuffer midi;
+
+        static String describe(int width, int height, float scale)
+        {
+            return "/size=" + String(width) + "x" + String(height) + "/scale=" + String(scale, 1);
+        }
+
+        static NamedValueSet makeParams(int width, int height, float scale)
+        {
+            NamedValueSet params;
+            params.set("width", width);
+            params.set("height", height);
+            params.set("scale", scale);
+            return params;
+        }
+
+        //runs one 60 Hz frame worth of audio through the processor
+        void feedFrame(CourseworkPluginAudioProcessor& processor)
+        {
+            auto remaining = roundToInt(sampleRate / frameRate);
+
+            while (remaining > 0)
+            {
+                const auto numSamples = jmin(remaining, blockSize);
+                input.setSize(2, numSamples, false, false, true);
+
+                for (int i = 0; i < numSamples; ++i, time += 1.0 / sampleRate)
+                {
+                    const auto fundamental = 110.0 * std::exp2(2.0 * std::sin(0.2 * time));
+
+                    auto sample = 0.0;
+                    for (int harmonic = 1; harmonic <= 8; ++harmonic)
+                        sample += 0.3 / harmonic * std::sin(MathConstants<double>::twoPi * fundamental * harmonic * time);
+
+                    for (int channel = 0; channel < 2; ++channel)
+                        input.setSample(channel, i, float(sample) + (random.nextFloat() - 0.5f) * 0.05f);
+                }
+
+                processor.processBlock(input, midi);
+                remaining -= numSamples;
+            }
+        }
+
+        //times paintFrame() once per frame, prepareFrame() runs before it outside the timing
+        template<typename Prepare, typename Paint>
+        void measureFrames(const String& id, const NamedValueSet& params, Prepare&& prepareFrame, Paint&& paintFrame)
+        {
+            const auto framesPerRun = jmax(1, roundToInt(runner.getSecondsPerRun() * frameRate));
+
+            runner.measure(id, "ns/frame", params, [&]
+            {
+                double elapsed = 0.0;
+
+                for (int i = 0; i < framesPerRun; ++i)
+                {
+                    prepareFrame();
+
+                    const auto start = Clock::now();
+                    paintFrame();
+                    elapsed += nanosecondsSince(start);
+                }
+
+                return Run{ elapsed, framesPerRun };
+            });
+        }
+
+        static void paintAt(Graphics& g, Component& component)
+        {
+            Graphics::ScopedSaveState state(g);
+            g.setOrigin(component.getPosition());
+            component.paintEntireComponent(g, false);
+        }
+
+        //the static layer when it's rebuilt, and a whole frame of the editor with every child
+        void runEditor(CourseworkPluginAudioProcessor& processor, CourseworkPluginAudioProcessorEditor& editor, float scale)
+        {
+            const auto width = editor.getWidth(), height = editor.getHeight();
+            const auto suffix = describe(width, height, scale);
+            const auto params = makeParams(width, height, scale);
+
+            measureFrames("ui/background" + suffix, params, [] {}, [&]
+            {
+                renderScaledLayer(width, height, scale, [&editor](Graphics& g) { editor.drawStaticLayer(g); });
+            });
+
+            Canvas canvas(width, height, scale);
+            measureFrames("ui/editor" + suffix, params, [&]
+            {
+                feedFrame(processor);
+                editor.frameTick();
+                editor.responseCurveComponent.frameTick();
+            },
+            [&]
+            {
+                editor.paintEntireComponent(canvas.graphics, false);
+            });
+        }
+
+        //sliders, and the meters with the waveform view and the loudness readout
+        void runControls(CourseworkPluginAudioProcessor& processor, CourseworkPluginAudioProcessorEditor& editor, float scale)
+        {
+            const auto width = editor.getWidth(), height = editor.getHeight();
+            const auto suffix = describe(width, height, scale);
+            const auto params = makeParams(width, height, scale);
+
+            Canvas canvas(width, height, scale);
+
+            std::vector<Component*> sliders{ &editor.lowCutFreqSlider, &editor.highCutFreqSlider,
+                                             &editor.driveSlider, &editor.postGainSlider,
+                                             &editor.lowCutSlopeSelect, &editor.highCutSlopeSelect,
+                                             &editor.distortionMix };
+
+            measureFrames("ui/sliders" + suffix, params, [] {}, [&]
+            {
+                for (auto* slider : sliders)
+                    paintAt(canvas.graphics, *slider);
+            });
+
+            std::vector<Component*> meters{ &editor.verticalMeterL, &editor.verticalMeterR,
+                                            &editor.waveformView, &editor.loudnessReadout };
+
+            measureFrames("ui/meters" + suffix, params, [&]
+            {
+                feedFrame(processor);
+                editor.frameTick();
+            },
+            [&]
+            {
+                for (auto* meter : meters)
+                    paintAt(canvas.graphics, *meter);
+            });
+        }
+
+        //the analyser's cached layers, the spectrum in each view and a whole cached frame
+        void runResponseCurve(CourseworkPluginAudioProcessor& processor, ResponseCurveComponent& curve, float scale)
+        {
+            const auto width = curve.getWidth(), height = curve.getHeight();
+            const auto suffix = describe(width, height, scale);
+            const auto params = makeParams(width, height, scale);
+            auto& apvts = processor.apvts;
+
+            measureFrames("ui/grid" + suffix, params, [] {}, [&]
+            {
+                renderScaledLayer(width, height, scale, [&curve](Graphics& g) { curve.drawBackgroundLayer(g); });
+            });
+
+            //a filter moving every frame, so the curve is recalculated and its layer redrawn
+            auto frequency = 100.f;
+            measureFrames("ui/responseCurve" + suffix, params, [&]
+            {
+                frequency = frequency < 1000.f ? frequency * 1.1f : 100.f;
+                setParameter(apvts, Params::LowCutFreq, frequency);
+            },
+            [&]
+            {
+                curve.updateChain();
+                renderScaledLayer(width, height, scale, [&curve](Graphics& g) { curve.drawCurveLayer(g); });
+            });
+
+            Canvas canvas(width, height, scale);
+
+            struct View { const char* name; float view; float hold; };
+            for (const auto& view : { View{ "spectrum", 0.f, 0.f }, View{ "peakHold", 0.f, 1.f }, View{ "spectrogram", 1.f, 0.f } })
+            {
+                setParameter(apvts, Params::AnalyzerView, view.view);
+                setParameter(apvts, Params::AnalyzerHold, view.hold);
+
+                auto viewParams = params;
+                viewParams.set("view", view.name);
+
+                //the message thread analysis that turns the fifos into paths
+                measureFrames("ui/analysis/" + String(view.name) + suffix, viewParams, [&] { feedFrame(processor); }, [&]
+                {
+                    curve.frameTick();
+                });
+
+                measureFrames("ui/fftPaths/" + String(view.name) + suffix, viewParams, [&]
+                {
+                    feedFrame(processor);
+                    curve.frameTick();
+                },
+                [&]
+                {
+                    curve.drawSpectrum(canvas.graphics);
+                });
+
+                measureFrames("ui/analyzer/" + String(view.name) + suffix, viewParams, [&]
+                {
+                    feedFrame(processor);
+                    curve.frameTick();
+                },
+                [&]
+                {
+                    curve.paint(canvas.graphics);
+                });
+            }
+
+            setParameter(apvts, Params::AnalyzerView, 0.f);
+            setParameter(apvts, Params::AnalyzerHold, 0.f);
+            setParameter(apvts, Params::LowCutFreq, 10.f);
+        }
+    };
+};
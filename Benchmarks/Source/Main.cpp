@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+    headless benchmarks for the plugin's hot paths.
+
+    usage: Benchmarks [dsp|ui|rtcheck|record|verify] [--full] [--repetitions N]
+                      [--seconds S] [--filter text,text] [--output results.json]
+                      [--baseline previous.json] [--tolerance percent]
+                      [--seed N] [--golden dir] [--max-error E] [--min-snr dB]
+                      [--max-db-error dB]
+
+    dsp times the processor, ui paints the editor into offscreen images.
+    results are written as JSON to --output, or to stdout without it. with
+    --baseline the exit code is the number of benchmarks whose median got
+    slower by more than --tolerance percent (10 by default).
+
+    rtcheck runs --seconds of randomly automated audio per configuration
+    through the processor with the real-time hooks armed and exits with 1 if
+    anything on the audio thread allocated, locked, blocked or overran. it
+    needs a build with COURSEWORK_RT_CHECKS=1, which Debug has.
+
+    record renders the regression signals into --golden. verify renders them
+    again and compares them with --golden, checks the filters' magnitude
+    response against the analytic Butterworth curves and checks that MIDI CC
+    automation renders the same at any block size, that saved states and
+    presets restore every parameter and that the analyser repaints when the
+    quality tier changes, exiting with 1 if anything is out of tolerance.
+    without --golden the renders are skipped.
+
+  ==============================================================================
+*/
+
+#include "EditorBenchmarks.h"
+#include "RealtimeCheck.h"
+#include "RegressionSuite.h"
+
+int main (int argc, char* argv[])
+{
+    using namespace juce;
+
+    //the processor's parameter state runs timers, so a message manager has to exist
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    ArgumentList args(argc, argv);
+
+    const auto mode = args.size() > 0 && !args[0].isOption() ? args[0].text : String("dsp");
+
+    StringArray filters;
+    if (args.containsOption("--filter"))
+        filters.addTokens(args.getValueForOption("--filter"), ",", "");
+
+    const auto repetitions = args.containsOption("--repetitions") ? args.getValueForOption("--repetitions").getIntValue() : 5;
+    const auto seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 1.0;
+
+    if (mode == "rtcheck")
+    {
+        const auto seed = args.containsOption("--seed") ? args.getValueForOption("--seed").getLargeIntValue() : 1;
+
+        Bench::RealtimeCheck check(seconds, seed);
+        return check.run() == 0 ? 0 : 1;
+    }
+
+    if (mode == "record" || mode == "verify")
+    {
+        Bench::Tolerance tolerance;
+        if (args.containsOption("--max-error"))
+            tolerance.maxError = args.getValueForOption("--max-error").getDoubleValue();
+        if (args.containsOption("--min-snr"))
+            tolerance.minSnr = args.getValueForOption("--min-snr").getDoubleValue();
+        if (args.containsOption("--max-db-error"))
+            tolerance.maxDecibelError = args.getValueForOption("--max-db-error").getDoubleValue();
+
+        Bench::RegressionSuite suite(tolerance);
+
+        if (mode == "record")
+        {
+            if (!args.containsOption("--golden"))
+            {
+                std::cerr << "record needs --golden dir" << std::endl;
+                return 1;
+            }
+
+            return suite.record(args.getFileForOption("--golden")) ? 0 : 1;
+        }
+
+        auto numFailed = suite.verifyResponses() + suite.verifyAutomation() + suite.verifyState() + suite.verifyQualityRepaint();
+        if (args.containsOption("--golden"))
+            numFailed += suite.verifyRenders(args.getFileForOption("--golden"));
+
+        return numFailed == 0 ? 0 : 1;
+    }
+
+    Bench::Runner runner(filters, repetitions, seconds);
+
+    if (mode == "dsp")
+    {
+        Bench::ProcessorBenchmarks benchmarks(runner);
+        benchmarks.runProcessBlock(args.containsOption("--full"));
+        benchmarks.runUpdateFilters();
+        benchmarks.runFFTDataGenerator();
+        benchmarks.runAnalyzerPathGenerator();
+    }
+    else if (mode == "ui")
+    {
+        Bench::EditorBenchmarks benchmarks(runner);
+        benchmarks.run();
+    }
+    else
+    {
+        std::cerr << "unknown mode: " << mode << std::endl;
+        return 1;
+    }
+
+    const auto json = JSON::toString(runner.toJson());
+
+    if (args.containsOption("--output"))
+    {
+        const auto file = args.getFileForOption("--output");
+        if (!file.replaceWithText(json))
+        {
+            std::cerr << "couldn't write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << json << std::endl;
+    }
+
+    if (args.containsOption("--baseline"))
+    {
+        const auto baseline = JSON::parse(args.getFileForOption("--baseline"));
+        const auto tolerance = args.containsOption("--tolerance") ? args.getValueForOption("--tolerance").getDoubleValue() : 10.0;
+
+        return runner.compareWithBaseline(baseline, tolerance);
+    }
+
+    return 0;
+}
@@ -0,0 +1,361 @@
+#pragma once
+
+#include "BenchmarkRunner.h"
+#include "../../Source/PluginEditor.h"
+
+namespace Bench
+{
+    //one processBlock configuration
+    struct ProcessorSettings
+    {
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        float lowCutFreq = 80.f, highCutFreq = 12000.f;
+        Slope lowCutSlope = Slope_12, highCutSlope = Slope_12;
+        bool lowCutBypassed = false, highCutBypassed = false;
+        float drive = 5.f;
+
+        //subscribes every capture stream, as if an editor was open
+        bool capture = false;
+    };
+
+    inline void setParameter(AudioProcessorValueTreeState& apvts, Params::Id id, float value)
+    {
+        auto* parameter = apvts.getParameter(Params::getID(id));
+        jassert(parameter != nullptr);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    //a slope as its dB/Oct, for ids
+    inline String slopeName(Slope slope) { return String(12 * (static_cast<int>(slope) + 1)); }
+
+    //the filters and the drive from the settings, at full quality so the governor can't change the work
+    inline void configure(CourseworkPluginAudioProcessor& processor, const ProcessorSettings& settings)
+    {
+        auto& apvts = processor.apvts;
+
+        setParameter(apvts, Params::LowCutFreq, settings.lowCutFreq);
+        setParameter(apvts, Params::HighCutFreq, settings.highCutFreq);
+        setParameter(apvts, Params::LowCutSlope, float(settings.lowCutSlope));
+        setParameter(apvts, Params::HighCutSlope, float(settings.highCutSlope));
+        setParameter(apvts, Params::LowCutBypassed, settings.lowCutBypassed ? 1.f : 0.f);
+        setParameter(apvts, Params::HighCutBypassed, settings.highCutBypassed ? 1.f : 0.f);
+        setParameter(apvts, Params::Drive, settings.drive);
+        setParameter(apvts, Params::QualityMode, 1.f);
+    }
+
+    //deterministic noise at about -12 dBFS, so every run processes the same signal
+    inline void fillWithNoise(AudioBuffer<float>& buffer, int64 seed)
+    {
+        Random random(seed);
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(channel, i, (random.nextFloat() * 2.f - 1.f) * 0.25f);
+    }
+
+    //stereo in and out at the rate and the largest block the harness will use
+    inline void prepare(CourseworkPluginAudioProcessor& processor, double sampleRate, int maxBlockSize)
+    {
+        processor.setPlayConfigDetails(2, 2, sampleRate, maxBlockSize);
+        processor.prepareToPlay(sampleRate, maxBlockSize);
+    }
+
+    //reads everything the capture paths hold, the way an open editor would, so they never back up.
+    //the scratch space is kept between calls so draining doesn't allocate
+    inline void drainCapture(CourseworkPluginAudioProcessor& processor)
+    {
+        static AudioBuffer<float> fifoBuffer;
+        static Dsp::TelemetrySnapshot snapshot;
+        static std::vector<Point<float>> points(Dsp::StereoAnalyzer::pointCapacity);
+
+        while (processor.leftChannelFifo.getAudioBuffer(fifoBuffer)) {}
+        while (processor.rightChannelFifo.getAudioBuffer(fifoBuffer)) {}
+        while (processor.preChannelFifo.getAudioBuffer(fifoBuffer)) {}
+        while (processor.stereoAnalyzer.readPoints(points.data(), static_cast<int>(points.size())) > 0) {}
+        processor.readTelemetry(snapshot);
+    }
+
+    class ProcessorBenchmarks
+    {
+    public:
+        explicit ProcessorBenchmarks(Runner& runnerToUse) : runner(runnerToUse) {}
+
+        /*
+         processBlock in ns/sample. by default every axis is swept on its own
+         around a base setting, full sweeps the whole cartesian product
+         */
+        void runProcessBlock(bool full)
+        {
+            const std::vector<double> sampleRates{ 44100.0, 48000.0, 88200.0, 96000.0, 192000.0 };
+            const std::vector<int> blockSizes{ 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+            const std::vector<float> drives{ 1.f, 5.f, 10.f };
+
+            const ProcessorSettings base;
+
+            if (full)
+            {
+                for (auto sampleRate : sampleRates)
+                    for (auto blockSize : blockSizes)
+                        for (int slopes = 0; slopes < 16; ++slopes)
+                            for (int bypass = 0; bypass < 4; ++bypass)
+                                for (auto drive : drives)
+                                    for (auto capture : { false, true })
+                                    {
+                                        auto settings = base;
+                                        settings.sampleRate = sampleRate;
+                                        settings.blockSize = blockSize;
+                                        settings.lowCutSlope = static_cast<Slope>(slopes % 4);
+                                        settings.highCutSlope = static_cast<Slope>(slopes / 4);
+                                        settings.lowCutBypassed = (bypass & 1) != 0;
+                                        settings.highCutBypassed = (bypass & 2) != 0;
+                                        settings.drive = drive;
+                                        settings.capture = capture;
+                                        measureProcessBlock(settings);
+                                    }
+                return;
+            }
+
+            for (auto sampleRate : sampleRates)
+                for (auto blockSize : blockSizes)
+                {
+                    auto settings = base;
+                    settings.sampleRate = sampleRate;
+                    settings.blockSize = blockSize;
+                    measureProcessBlock(settings);
+                }
+
+            for (int slopes = 0; slopes < 16; ++slopes)
+            {
+                auto settings = base;
+                settings.lowCutSlope = static_cast<Slope>(slopes % 4);
+                settings.highCutSlope = static_cast<Slope>(slopes / 4);
+                measureProcessBlock(settings);
+            }
+
+            for (int bypass = 1; bypass < 4; ++bypass)
+            {
+                auto settings = base;
+                settings.lowCutBypassed = (bypass & 1) != 0;
+                settings.highCutBypassed = (bypass & 2) != 0;
+                measureProcessBlock(settings);
+            }
+
+            for (auto drive : drives)
+                for (auto capture : { false, true })
+                {
+                    auto settings = base;
+                    settings.drive = drive;
+                    settings.capture = capture;
+                    measureProcessBlock(settings);
+                }
+        }
+
+        /*
+         the coefficient update processBlock does when a filter parameter's
+         version changes: both Butterworth designs and the in place copy into
+         both channels' chains. blocks where none of them moved skip it.
+         updateFilters() is private, so this makes the same calls it does
+         */
+        void runUpdateFilters()
+        {
+            constexpr int callsPerRun = 2000;
+            constexpr double sampleRate = 48000.0;
+
+            for (int slopes = 0; slopes < 16; ++slopes)
+            {
+                ChainSettings chainSettings;
+                chainSettings.lowCutFreq = 80.f;
+                chainSettings.highCutFreq = 12000.f;
+                chainSettings.lowCutSlope = static_cast<Slope>(slopes % 4);
+                chainSettings.highCutSlope = static_cast<Slope>(slopes / 4);
+
+                const auto id = "updateFilters/low=" + slopeName(chainSettings.lowCutSlope) + "/high=" + slopeName(chainSettings.highCutSlope);
+
+                NamedValueSet params;
+                params.set("lowCutSlope", slopeName(chainSettings.lowCutSlope));
+                params.set("highCutSlope", slopeName(chainSettings.highCutSlope));
+
+                runner.measure(id, "ns/call", params, [&]
+                {
+                    MonoChain left, right;
+
+                    dsp::ProcessSpec spec{ sampleRate, 512, 1 };
+                    left.prepare(spec);
+                    right.prepare(spec);
+                    prepareCutFilterCoefficients(left);
+                    prepareCutFilterCoefficients(right);
+
+                    Dsp::ButterworthSections lowCut, highCut;
+
+                    const auto start = Clock::now();
+                    for (int i = 0; i < callsPerRun; ++i)
+                    {
+                        Dsp::Butterworth::designHighPass(chainSettings.lowCutFreq, sampleRate, 2 * (chainSettings.lowCutSlope + 1), lowCut);
+                        updateFilter(left.get<ChainPositions::LowCut>(), lowCut, chainSettings.lowCutSlope);
+                        updateFilter(right.get<ChainPositions::LowCut>(), lowCut, chainSettings.lowCutSlope);
+
+                        Dsp::Butterworth::designLowPass(chainSettings.highCutFreq, sampleRate, 2 * (chainSettings.highCutSlope + 1), highCut);
+                        updateFilter(left.get<ChainPositions::HighCut>(), highCut, chainSettings.highCutSlope);
+                        updateFilter(right.get<ChainPositions::HighCut>(), highCut, chainSettings.highCutSlope);
+                    }
+
+                    return Run{ nanosecondsSince(start), callsPerRun };
+                });
+            }
+        }
+
+        //one analyser frame at each FFT size, the fifo is drained between calls outside the timing
+        void runFFTDataGenerator()
+        {
+            constexpr int callsPerRun = 200;
+
+            for (auto order : { FFTOrder::order2048, FFTOrder::order4096, FFTOrder::order8192 })
+            {
+                const auto fftSize = 1 << order;
+
+                NamedValueSet params;
+                params.set("fftSize", fftSize);
+
+                runner.measure("produceFFTDataForRendering/fft=" + String(fftSize), "ns/call", params, [&]
+                {
+                    FFTDataGenerator<std::vector<float>> generator;
+                    generator.changeOrder(order);
+
+                    AudioBuffer<float> first(1, fftSize), second(1, fftSize);
+                    fillWithNoise(first, 1);
+                    fillWithNoise(second, 2);
+
+                    std::vector<float> drained;
+                    double elapsed = 0.0;
+
+                    for (int i = 0; i < callsPerRun; ++i)
+                    {
+                        const auto start = Clock::now();
+                        generator.produceFFTDataForRendering(first, second, -48.f);
+                        elapsed += nanosecondsSince(start);
+
+                        while (generator.getFFTData(drained)) {}
+                    }
+
+                    return Run{ elapsed, callsPerRun };
+                });
+            }
+        }
+
+        //one path from a single spectrum at several editor widths, the fifo is drained outside the timing
+        void runAnalyzerPathGenerator()
+        {
+            constexpr int callsPerRun = 500;
+            constexpr double sampleRate = 48000.0;
+
+            for (auto order : { FFTOrder::order2048, FFTOrder::order8192 })
+                for (auto width : { 400, 800, 1600 })
+                {
+                    const auto fftSize = 1 << order;
+
+                    NamedValueSet params;
+                    params.set("fftSize", fftSize);
+                    params.set("width", width);
+
+                    const auto id = "generatePath/fft=" + String(fftSize) + "/width=" + String(width);
+
+                    runner.measure(id, "ns/call", params, [&]
+                    {
+                        AnalyzerPathGenerator<Path> generator;
+
+                        //a noisy spectrum falling off with frequency
+                        std::vector<float> renderData(static_cast<size_t>(fftSize));
+                        Random random(3);
+                        for (size_t i = 0; i < renderData.size(); ++i)
+                            renderData[i] = -12.f - 30.f * float(i) / float(renderData.size()) - 6.f * random.nextFloat();
+
+                        const auto bounds = Rectangle<float>(0.f, 0.f, float(width), 300.f);
+                        const auto binWidth = float(sampleRate / fftSize);
+
+                        Path drained;
+                        double elapsed = 0.0;
+
+                        for (int i = 0; i < callsPerRun; ++i)
+                        {
+                            const auto start = Clock::now();
+                            generator.generatePath(renderData, bounds, fftSize, binWidth, -48.f);
+                            elapsed += nanosecondsSince(start);
+
+                            while (generator.getPath(drained)) {}
+                        }
+
+                        return Run{ elapsed, callsPerRun };
+                    });
+                }
+        }
+    private:
+        Runner& runner;
+
+        static String makeId(const ProcessorSettings& s)
+        {
+            return "processBlock/sr=" + String(roundToInt(s.sampleRate))
+                + "/block=" + String(s.blockSize)
+                + "/low=" + (s.lowCutBypassed ? String("off") : slopeName(s.lowCutSlope))
+                + "/high=" + (s.highCutBypassed ? String("off") : slopeName(s.highCutSlope))
+                + "/drive=" + String(s.drive, 1)
+                + (s.capture ? "/capture" : "");
+        }
+
+        void measureProcessBlock(const ProcessorSettings& settings)
+        {
+            const auto id = makeId(settings);
+            if (!runner.shouldRun(id))
+                return;
+
+            CourseworkPluginAudioProcessor processor;
+            configure(processor, settings);
+            prepare(processor, settings.sampleRate, settings.blockSize);
+
+            std::vector<CaptureRegistry::Subscription> subscriptions;
+            if (settings.capture)
+                for (int i = 0; i < static_cast<int>(CaptureStream::NumStreams); ++i)
+                    subscriptions.push_back(processor.captureRegistry.subscribe(static_cast<CaptureStream>(i)));
+
+            //whole blocks covering about secondsPerRun of audio
+            const auto numBlocks = jmax(1, roundToInt(runner.getSecondsPerRun() * settings.sampleRate / settings.blockSize));
+            AudioBuffer<float> source(2, numBlocks * settings.blockSize);
+            fillWithNoise(source, 4);
+
+            AudioBuffer<float> block(2, settings.blockSize);
+            MidiBuffer midi;
+
+            NamedValueSet params;
+            params.set("sampleRate", settings.sampleRate);
+            params.set("blockSize", settings.blockSize);
+            params.set("lowCutSlope", slopeName(settings.lowCutSlope));
+            params.set("highCutSlope", slopeName(settings.highCutSlope));
+            params.set("lowCutBypassed", settings.lowCutBypassed);
+            params.set("highCutBypassed", settings.highCutBypassed);
+            params.set("drive", settings.drive);
+            params.set("capture", settings.capture);
+
+            runner.measure(id, "ns/sample", params, [&]
+            {
+                double elapsed = 0.0;
+
+                for (int i = 0; i < numBlocks; ++i)
+                {
+                    for (int channel = 0; channel < 2; ++channel)
+                        block.copyFrom(channel, 0, source, channel, i * settings.blockSize, settings.blockSize);
+
+                    const auto start = Clock::now();
+                    processor.processBlock(block, midi);
+                    elapsed += nanosecondsSince(start);
+
+                    if (settings.capture)
+                        drainCapture(processor);
+                }
+
+                return Run{ elapsed, (int64)numBlocks * settings.blockSize };
+            });
+
+            processor.releaseResources();
+        }
+    };
+};
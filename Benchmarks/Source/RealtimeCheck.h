@@ -0,0 +1,187 @@
+#pragma once
+
+#include "ProcessorBenchmarks.h"
+
+namespace Bench
+{
+    /*
+     runs the processor under the real-time hooks in RealtimeHooks.cpp with
+     random block sizes, random parameter automation, capture streams
+     coming and going, and state restores, at a few sample rates. anything
+     processBlock allocates, locks or blocks on is reported, and a watchdog
+     thread reports a block that runs for much longer than its own duration.
+
+     the automation and the fifo draining happen between blocks, outside the
+     real-time sections, the way a host and an editor would do them.
+     */
+    class RealtimeCheck
+    {
+    public:
+        RealtimeCheck(double secondsToRun, int64 seedToUse) : seconds(secondsToRun), seed(seedToUse) {}
+
+        //returns the number of violations
+        int run()
+        {
+           #if COURSEWORK_RT_CHECKS
+            Dsp::RealtimeGuard::clear();
+
+            Watchdog watchdog;
+            watchdog.startThread();
+
+            Random random(seed);
+
+            for (auto sampleRate : { 44100.0, 48000.0, 96000.0 })
+                for (auto maxBlockSize : { 64, 512, 2048 })
+                {
+                    //a block may legitimately take a while in a debug build, so only a stuck one is flagged
+                    watchdog.setLimit(jmax(0.01, 4.0 * maxBlockSize / sampleRate));
+                    runConfiguration(sampleRate, maxBlockSize, random);
+                }
+
+            watchdog.stopThread(1000);
+
+            printSummary();
+            return static_cast<int>(jmin<uint64>(Dsp::RealtimeGuard::getTotalCount(), std::numeric_limits<int>::max()));
+           #else
+            std::cerr << "rtcheck needs a build with COURSEWORK_RT_CHECKS=1, the Debug configuration sets it" << std::endl;
+            return -1;
+           #endif
+        }
+    private:
+        double seconds;
+        int64 seed;
+
+       #if COURSEWORK_RT_CHECKS
+        //flags a real-time section that has been running for longer than the limit
+        class Watchdog : public Thread
+        {
+        public:
+            Watchdog() : Thread("rtcheck watchdog") {}
+
+            void setLimit(double limitSeconds) { limitTicks.store(Time::secondsToHighResolutionTicks(limitSeconds)); }
+
+            void run() override
+            {
+                uint64 flaggedEntry = 0;
+
+                while (!threadShouldExit())
+                {
+                    const auto entry = Dsp::RealtimeGuard::getActiveEntry();
+                    const auto elapsed = Time::getHighResolutionTicks() - Dsp::RealtimeGuard::getActiveSinceTicks();
+
+                    //still the same section, and it's been going for too long
+                    if ((entry & 1) != 0 && entry != flaggedEntry && elapsed > limitTicks.load()
+                        && Dsp::RealtimeGuard::getActiveEntry() == entry)
+                    {
+                        flaggedEntry = entry;
+
+                        const auto detail = "a section ran for over " + String(Time::highResolutionTicksToSeconds(elapsed) * 1000.0, 1) + " ms";
+                        Dsp::RealtimeGuard::report(Dsp::RealtimeViolation::Overrun, detail.toRawUTF8());
+                    }
+
+                    wait(1);
+                }
+            }
+        private:
+            std::atomic<int64> limitTicks{ 0 };
+        };
+
+        void runConfiguration(double sampleRate, int maxBlockSize, Random& random)
+        {
+            CourseworkPluginAudioProcessor processor;
+            prepare(processor, sampleRate, maxBlockSize);
+
+            AudioBuffer<float> source(2, maxBlockSize), block(2, maxBlockSize);
+            MidiBuffer midi;
+
+            std::array<CaptureRegistry::Subscription, static_cast<size_t>(CaptureStream::NumStreams)> subscriptions;
+
+            MemoryBlock savedState;
+            processor.getStateInformation(savedState);
+
+            const auto totalSamples = static_cast<int64>(seconds * sampleRate);
+            int64 processed = 0;
+
+            while (processed < totalSamples)
+            {
+                //automation, about one parameter in eight moves each block
+                for (auto* parameter : processor.getParameters())
+                    if (random.nextInt(8) == 0)
+                        parameter->setValueNotifyingHost(random.nextFloat());
+
+                //an editor opening and closing its views
+                for (size_t i = 0; i < subscriptions.size(); ++i)
+                {
+                    if (random.nextInt(64) != 0)
+                        continue;
+
+                    const auto stream = static_cast<CaptureStream>(i);
+                    if (processor.captureRegistry.isSubscribed(stream))
+                        subscriptions[i].release();
+                    else
+                        subscriptions[i] = processor.captureRegistry.subscribe(stream);
+                }
+
+                if (random.nextInt(256) == 0)
+                    processor.loudnessMeter.requestReset();
+
+                //a preset recalled now and then, swapped with the current state so the next recall changes something
+                if (random.nextInt(128) == 0)
+                {
+                    MemoryBlock currentState;
+                    processor.getStateInformation(currentState);
+                    processor.setStateInformation(savedState.getData(), static_cast<int>(savedState.getSize()));
+                    savedState = std::move(currentState);
+                }
+
+                //CC automation now and then, so processBlock splits the block
+                midi.clear();
+                if (random.nextInt(4) == 0)
+                    for (int i = random.nextInt({ 1, 5 }); --i >= 0;)
+                        midi.addEvent(MidiMessage::controllerEvent(1, firstAutomationController + random.nextInt(static_cast<int>(automatedParameters.size())), random.nextInt(128)),
+                                      random.nextInt(maxBlockSize));
+
+                //hosts may send any block size up to the one they prepared with
+                const auto numSamples = random.nextInt({ 1, maxBlockSize + 1 });
+                if (!midi.isEmpty())
+                    midi.clear(numSamples, maxBlockSize);
+
+                //quiet noise mostly, now and then something hot enough to clip
+                fillWithNoise(source, random.nextInt64());
+                block.setSize(2, numSamples, false, false, true);
+                for (int channel = 0; channel < 2; ++channel)
+                    block.copyFrom(channel, 0, source, channel, 0, numSamples);
+
+                if (random.nextInt(16) == 0)
+                    block.applyGain(8.f);
+
+                processor.processBlock(block, midi);
+                processed += numSamples;
+
+                drainCapture(processor);
+            }
+
+            processor.releaseResources();
+
+            std::cout << "sr=" << roundToInt(sampleRate) << " maxBlock=" << maxBlockSize
+                      << ": " << Dsp::RealtimeGuard::getTotalCount() << " violations so far" << std::endl;
+        }
+
+        static void printSummary()
+        {
+            for (int i = 0; i < static_cast<int>(Dsp::RealtimeViolation::NumKinds); ++i)
+            {
+                const auto kind = static_cast<Dsp::RealtimeViolation>(i);
+                std::cout << Dsp::getRealtimeViolationName(kind) << ": " << Dsp::RealtimeGuard::getCount(kind) << std::endl;
+            }
+
+            for (int i = 0; i < Dsp::RealtimeGuard::getNumReports(); ++i)
+            {
+                const auto& report = Dsp::RealtimeGuard::getReport(i);
+                const auto* scope = report.scope[0] != 0 ? report.scope : "the audio thread";
+                std::cout << "  " << Dsp::getRealtimeViolationName(report.kind) << " in " << scope << ": " << report.detail << std::endl;
+            }
+        }
+       #endif
+    };
+}
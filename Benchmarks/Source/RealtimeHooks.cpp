@@ -0,0 +1,283 @@
+/*
+  ==============================================================================
+
+    allocation, lock and blocking call hooks for the rt-check mode. only
+    built with COURSEWORK_RT_CHECKS=1, which the Debug configuration sets.
+
+    every hook asks Dsp::RealtimeGuard whether this thread is inside a
+    real-time section, reports if it is, then carries on with the real call
+    so the run keeps going and every violation gets counted.
+
+    on Linux the C allocator, pthread locks and the usual blocking calls are
+    interposed, operator new ends up in malloc so it's covered too. elsewhere
+    only operator new and delete are replaced.
+
+  ==============================================================================
+*/
+
+#include "../../Source/DSP/RealtimeGuard.h"
+
+#if COURSEWORK_RT_CHECKS
+
+namespace
+{
+    using Dsp::RealtimeViolation;
+
+    inline void check(RealtimeViolation kind, const char* what) noexcept
+    {
+        if (Dsp::RealtimeGuard::isInRealtimeScope())
+        {
+            //nothing the report does should be reported again
+            const Dsp::RealtimeGuard::ScopedPause pause;
+            Dsp::RealtimeGuard::report(kind, what);
+        }
+    }
+}
+
+#if JUCE_LINUX
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/select.h>
+#include <time.h>
+#include <unistd.h>
+
+//glibc's allocator under its internal names, the replacements below forward to it
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void* __libc_memalign(size_t, size_t);
+extern "C" void __libc_free(void*);
+
+namespace
+{
+    //the next definition of a libc function, looked up the first time it's used.
+    //constant initialised, so it works before static constructors have run
+    template<typename Function>
+    struct Next
+    {
+        constexpr explicit Next(const char* nameToUse) : name(nameToUse) {}
+
+        Function* get() noexcept
+        {
+            auto* f = function.load(std::memory_order_acquire);
+            if (f == nullptr)
+            {
+                f = reinterpret_cast<Function*>(dlsym(RTLD_NEXT, name));
+                function.store(f, std::memory_order_release);
+            }
+            return f;
+        }
+
+        const char* name;
+        std::atomic<Function*> function{ nullptr };
+    };
+
+    Next<int(pthread_mutex_t*)> nextMutexLock{ "pthread_mutex_lock" };
+    Next<int(pthread_rwlock_t*)> nextReadLock{ "pthread_rwlock_rdlock" };
+    Next<int(pthread_rwlock_t*)> nextWriteLock{ "pthread_rwlock_wrlock" };
+    Next<int(pthread_cond_t*, pthread_mutex_t*)> nextCondWait{ "pthread_cond_wait" };
+    Next<int(pthread_cond_t*, pthread_mutex_t*, const timespec*)> nextCondTimedWait{ "pthread_cond_timedwait" };
+    Next<int(sem_t*)> nextSemWait{ "sem_wait" };
+    Next<int(pthread_t, void**)> nextJoin{ "pthread_join" };
+    Next<int(const timespec*, timespec*)> nextNanosleep{ "nanosleep" };
+    Next<int(clockid_t, int, const timespec*, timespec*)> nextClockNanosleep{ "clock_nanosleep" };
+    Next<int(useconds_t)> nextUsleep{ "usleep" };
+    Next<ssize_t(int, void*, size_t)> nextRead{ "read" };
+    Next<ssize_t(int, const void*, size_t)> nextWrite{ "write" };
+    Next<FILE*(const char*, const char*)> nextFopen{ "fopen" };
+    Next<int(pollfd*, nfds_t, int)> nextPoll{ "poll" };
+    Next<int(int, fd_set*, fd_set*, fd_set*, timeval*)> nextSelect{ "select" };
+}
+
+extern "C"
+{
+    //allocator
+    void* malloc(size_t size) noexcept
+    {
+        check(RealtimeViolation::Allocation, "malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        check(RealtimeViolation::Allocation, "calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size) noexcept
+    {
+        check(RealtimeViolation::Allocation, "realloc");
+        return __libc_realloc(pointer, size);
+    }
+
+    void* memalign(size_t alignment, size_t size) noexcept
+    {
+        check(RealtimeViolation::Allocation, "memalign");
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) noexcept
+    {
+        check(RealtimeViolation::Allocation, "aligned_alloc");
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** pointer, size_t alignment, size_t size) noexcept
+    {
+        check(RealtimeViolation::Allocation, "posix_memalign");
+        *pointer = __libc_memalign(alignment, size);
+        return *pointer != nullptr ? 0 : ENOMEM;
+    }
+
+    void free(void* pointer) noexcept
+    {
+        if (pointer != nullptr)
+            check(RealtimeViolation::Deallocation, "free");
+
+        __libc_free(pointer);
+    }
+
+    //locks, trylock never blocks so it's left alone
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        check(RealtimeViolation::Lock, "pthread_mutex_lock");
+        return nextMutexLock.get()(mutex);
+    }
+
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock) noexcept
+    {
+        check(RealtimeViolation::Lock, "pthread_rwlock_rdlock");
+        return nextReadLock.get()(lock);
+    }
+
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock) noexcept
+    {
+        check(RealtimeViolation::Lock, "pthread_rwlock_wrlock");
+        return nextWriteLock.get()(lock);
+    }
+
+    //waits and sleeps
+    int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+    {
+        check(RealtimeViolation::BlockingCall, "pthread_cond_wait");
+        return nextCondWait.get()(condition, mutex);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const timespec* time)
+    {
+        check(RealtimeViolation::BlockingCall, "pthread_cond_timedwait");
+        return nextCondTimedWait.get()(condition, mutex, time);
+    }
+
+    int sem_wait(sem_t* semaphore)
+    {
+        check(RealtimeViolation::BlockingCall, "sem_wait");
+        return nextSemWait.get()(semaphore);
+    }
+
+    int pthread_join(pthread_t thread, void** result)
+    {
+        check(RealtimeViolation::BlockingCall, "pthread_join");
+        return nextJoin.get()(thread, result);
+    }
+
+    int nanosleep(const timespec* duration, timespec* remaining)
+    {
+        check(RealtimeViolation::BlockingCall, "nanosleep");
+        return nextNanosleep.get()(duration, remaining);
+    }
+
+    int clock_nanosleep(clockid_t clock, int flags, const timespec* duration, timespec* remaining)
+    {
+        check(RealtimeViolation::BlockingCall, "clock_nanosleep");
+        return nextClockNanosleep.get()(clock, flags, duration, remaining);
+    }
+
+    int usleep(useconds_t microseconds)
+    {
+        check(RealtimeViolation::BlockingCall, "usleep");
+        return nextUsleep.get()(microseconds);
+    }
+
+    //file and device io
+    ssize_t read(int fd, void* buffer, size_t size)
+    {
+        check(RealtimeViolation::BlockingCall, "read");
+        return nextRead.get()(fd, buffer, size);
+    }
+
+    ssize_t write(int fd, const void* buffer, size_t size)
+    {
+        check(RealtimeViolation::BlockingCall, "write");
+        return nextWrite.get()(fd, buffer, size);
+    }
+
+    FILE* fopen(const char* path, const char* mode)
+    {
+        check(RealtimeViolation::BlockingCall, "fopen");
+        return nextFopen.get()(path, mode);
+    }
+
+    int poll(pollfd* fds, nfds_t numFds, int timeout)
+    {
+        check(RealtimeViolation::BlockingCall, "poll");
+        return nextPoll.get()(fds, numFds, timeout);
+    }
+
+    int select(int numFds, fd_set* readFds, fd_set* writeFds, fd_set* exceptFds, timeval* timeout)
+    {
+        check(RealtimeViolation::BlockingCall, "select");
+        return nextSelect.get()(numFds, readFds, writeFds, exceptFds, timeout);
+    }
+}
+
+#else
+
+#include <new>
+
+void* operator new(std::size_t size)
+{
+    check(RealtimeViolation::Allocation, "operator new");
+
+    if (auto* pointer = std::malloc(size))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    check(RealtimeViolation::Allocation, "operator new[]");
+
+    if (auto* pointer = std::malloc(size))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        check(RealtimeViolation::Deallocation, "operator delete");
+
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        check(RealtimeViolation::Deallocation, "operator delete[]");
+
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept { operator delete(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { operator delete[](pointer); }
+
+#endif
+
+#endif
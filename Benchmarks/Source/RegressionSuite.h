@@ -0,0 +1,620 @@
+#pragma once
+
+#include "ProcessorBenchmarks.h"
+
+namespace Bench
+{
+    //how far a result may drift before the suite fails
+    struct Tolerance
+    {
+        //golden renders, the largest single sample difference and the reference to error ratio in dB
+        double maxError = 1.0e-4;
+        double minSnr = 90.0;
+
+        //response curves, compared wherever the analytic curve is above floorDecibels
+        double maxDecibelError = 0.1;
+        double floorDecibels = -60.0;
+    };
+
+    /*
+     a safety net for changes to the filter and distortion paths.
+
+     record renders sweeps, impulses and noise through the processor for
+     every slope, bypass and drive combination and writes each result as a
+     32 bit float wav. verify renders them again and compares them with the
+     stored ones. the goldens are only meaningful from a build that's known
+     to be right, so record them before the change that's being checked.
+
+     verify also checks the cut filters' magnitude response against the
+     analytic Butterworth curve: the JUCE designers through
+     getMagnitudeForFrequency, Dsp::Butterworth's sections through the
+     editor's MagnitudeResponseEvaluator, and that both designs give the same
+     coefficients.
+
+     the state checks need no goldens, they restore saved states and presets
+     and compare the parameters they end up with. neither does the quality
+     check, which makes sure the editor notices a tier change.
+     */
+    class RegressionSuite
+    {
+    public:
+        explicit RegressionSuite(const Tolerance& toleranceToUse) : tolerance(toleranceToUse) {}
+
+        //returns false if anything couldn't be written
+        bool record(const File& goldenDirectory)
+        {
+            int numWritten = 0;
+
+            for (const auto& renderCase : getRenderCases())
+            {
+                const auto file = getGoldenFile(goldenDirectory, renderCase);
+                if (!writeWav(file, render(renderCase), renderCase.settings.sampleRate))
+                {
+                    std::cerr << "couldn't write " << file.getFullPathName() << std::endl;
+                    return false;
+                }
+
+                ++numWritten;
+            }
+
+            std::cout << numWritten << " goldens written to " << goldenDirectory.getFullPathName() << std::endl;
+            return true;
+        }
+
+        //returns the number of renders that drifted or had no golden
+        int verifyRenders(const File& goldenDirectory)
+        {
+            int numFailed = 0, numChecked = 0;
+            double worstError = 0.0, worstSnr = std::numeric_limits<double>::infinity();
+
+            for (const auto& renderCase : getRenderCases())
+            {
+                ++numChecked;
+
+                const auto file = getGoldenFile(goldenDirectory, renderCase);
+                AudioBuffer<float> golden;
+
+                if (!readWav(file, golden))
+                {
+                    std::cout << "FAIL " << renderCase.getId() << ": no golden at " << file.getFullPathName() << std::endl;
+                    ++numFailed;
+                    continue;
+                }
+
+                const auto difference = compare(golden, render(renderCase));
+                worstError = jmax(worstError, difference.maxError);
+                worstSnr = jmin(worstSnr, difference.snr);
+
+                if (difference.maxError > tolerance.maxError || difference.snr < tolerance.minSnr)
+                {
+                    std::cout << "FAIL " << renderCase.getId() << ": max error " << difference.maxError
+                              << ", snr " << difference.snr << " dB" << std::endl;
+                    ++numFailed;
+                }
+            }
+
+            std::cout << "renders: " << (numChecked - numFailed) << " of " << numChecked << " within tolerance, worst error "
+                      << worstError << ", worst snr " << worstSnr << " dB" << std::endl;
+
+            return numFailed;
+        }
+
+        /*
+         renders noise with MIDI CC automation of every target at several block
+         sizes. the CCs are split into the blocks at their absolute positions,
+         so sample accurate automation has to give the same output every time.
+         returns the number of block sizes that didn't
+         */
+        int verifyAutomation()
+        {
+            constexpr double sampleRate = 48000.0;
+
+            MidiBuffer automation;
+            Random random(6);
+
+            for (int i = 0; i < 96; ++i)
+            {
+                const auto controller = firstAutomationController + random.nextInt(static_cast<int>(automatedParameters.size()));
+                automation.addEvent(MidiMessage::controllerEvent(1, controller, random.nextInt(128)), random.nextInt(numSamples));
+            }
+
+            const auto reference = renderAutomated(automation, sampleRate, numSamples);
+            int numFailed = 0;
+
+            for (auto blockSize : { 1, 7, 64, 333, 512 })
+            {
+                const auto difference = compare(reference, renderAutomated(automation, sampleRate, blockSize));
+
+                if (difference.maxError > tolerance.maxError)
+                {
+                    std::cout << "FAIL automation/block=" << blockSize << ": max error " << difference.maxError
+                              << " against a single block" << std::endl;
+                    ++numFailed;
+                }
+            }
+
+            std::cout << "automation: " << (5 - numFailed) << " of 5 block sizes match a single block" << std::endl;
+            return numFailed;
+        }
+
+        /*
+         saves and restores the processor's state through the binary format,
+         a ValueTree from before it and a blob from an older version with
+         fewer parameters, and switches through every factory preset. each
+         has to leave the parameters exactly where it says.
+         returns the number of cases that didn't
+         */
+        int verifyState()
+        {
+            int numFailed = 0, numChecked = 0;
+
+            auto check = [&](const String& id, CourseworkPluginAudioProcessor& processor, const StateFormat::Values& expected)
+            {
+                ++numChecked;
+
+                for (const auto& info : Params::table)
+                {
+                    if (!Params::isSaved(info.index))
+                        continue;
+
+                    auto& parameter = processor.parameters.getParameter(info.index);
+                    const auto value = processor.parameters.getRawValue(info.index).load();
+                    const auto wanted = parameter.convertFrom0to1(parameter.convertTo0to1(expected[static_cast<size_t>(info.index)]));
+
+                    if (std::abs(value - wanted) > 1.0e-6f)
+                    {
+                        std::cout << "FAIL state/" << id << ": " << info.id << " is " << value << ", expected " << wanted << std::endl;
+                        ++numFailed;
+                        return;
+                    }
+                }
+            };
+
+            Random random(7);
+            CourseworkPluginAudioProcessor source;
+
+            for (auto* parameter : source.getParameters())
+                parameter->setValueNotifyingHost(random.nextFloat());
+
+            StateFormat::Values saved;
+            for (const auto& info : Params::table)
+                saved[static_cast<size_t>(info.index)] = source.parameters.getRawValue(info.index).load();
+
+            {
+                MemoryBlock blob;
+                source.getStateInformation(blob);
+
+                CourseworkPluginAudioProcessor restored;
+                restored.setStateInformation(blob.getData(), static_cast<int>(blob.getSize()));
+                check("binary", restored, saved);
+            }
+
+            {
+                MemoryBlock blob;
+                MemoryOutputStream stream(blob, false);
+                source.apvts.copyState().writeToStream(stream);
+                stream.flush();
+
+                CourseworkPluginAudioProcessor restored;
+                restored.setStateInformation(blob.getData(), static_cast<int>(blob.getSize()));
+                check("valueTree", restored, saved);
+            }
+
+            {
+                //as if the last two parameters had been added after the blob was saved. the last
+                //one isn't saved, so the one before it is what's checked
+                constexpr int numDropped = 2;
+
+                MemoryBlock blob;
+                source.getStateInformation(blob);
+                blob.setSize(blob.getSize() - numDropped * sizeof(float));
+
+                const auto numValues = static_cast<uint16>(Params::NumParameters - numDropped);
+                blob[6] = static_cast<char>(numValues & 0xff);
+                blob[7] = static_cast<char>(numValues >> 8);
+
+                auto expected = saved;
+                for (int i = Params::NumParameters - numDropped; i < Params::NumParameters; ++i)
+                    expected[static_cast<size_t>(i)] = Params::table[static_cast<size_t>(i)].defaultValue;
+
+                CourseworkPluginAudioProcessor restored;
+                restored.setStateInformation(blob.getData(), static_cast<int>(blob.getSize()));
+                check("olderVersion", restored, expected);
+            }
+
+            {
+                //a preset sets the sound and leaves the rest, here the random values
+                CourseworkPluginAudioProcessor processor;
+
+                for (auto* parameter : processor.getParameters())
+                    parameter->setValueNotifyingHost(random.nextFloat());
+
+                for (int i = 0; i < processor.getNumPrograms(); ++i)
+                {
+                    StateFormat::Values expected;
+                    for (const auto& info : Params::table)
+                        expected[static_cast<size_t>(info.index)] = processor.parameters.getRawValue(info.index).load();
+
+                    for (auto id : Presets::parameters)
+                        expected[static_cast<size_t>(id)] = Presets::getFactoryPresets()[static_cast<size_t>(i)].values[static_cast<size_t>(id)];
+
+                    processor.setCurrentProgram(i);
+                    check("preset/" + processor.getProgramName(i), processor, expected);
+                }
+            }
+
+            std::cout << "state: " << (numChecked - numFailed) << " of " << numChecked << " restores match" << std::endl;
+            return numFailed;
+        }
+
+        /*
+         from Reduced on the analyser isn't fed, so with the spectrum on the
+         tier change has to repaint the analyser by itself, or the banner that
+         says why it stopped never shows. returns 1 if it doesn't
+         */
+        int verifyQualityRepaint()
+        {
+            constexpr double sampleRate = 48000.0;
+            constexpr int blockSize = 512;
+
+            CourseworkPluginAudioProcessor processor;
+            prepare(processor, sampleRate, blockSize);
+
+            AudioBuffer<float> buffer(2, blockSize);
+            MidiBuffer midi;
+            bool repainted = false;
+
+            {
+                CourseworkPluginAudioProcessorEditor editor(processor);
+                auto& curve = editor.responseCurveComponent;
+
+                setParameter(processor.apvts, Params::SpectrumEnabled, 1.f);
+                setParameter(processor.apvts, Params::QualityMode, 1.f);
+
+                //the analyser running at full quality, then everything it was fed analysed
+                for (int i = 0; i < 16; ++i)
+                {
+                    fillWithNoise(buffer, i);
+                    processor.processBlock(buffer, midi);
+                }
+
+                for (int i = 0; i < 64 && curve.frameTick(); ++i) {}
+
+                //the tier only changes with the next block
+                setParameter(processor.apvts, Params::QualityMode, 2.f);
+                curve.frameTick();
+
+                fillWithNoise(buffer, 16);
+                processor.processBlock(buffer, midi);
+
+                repainted = processor.getQualityTier() == Dsp::QualityTier::Reduced && curve.frameTick();
+            }
+
+            processor.releaseResources();
+
+            if (!repainted)
+            {
+                std::cout << "FAIL quality/repaint: the analyser didn't repaint for the Reduced tier" << std::endl;
+                return 1;
+            }
+
+            std::cout << "quality: the analyser repaints for a tier change" << std::endl;
+            return 0;
+        }
+
+        //returns the number of filter designs whose response or coefficients are off
+        int verifyResponses()
+        {
+            constexpr int numPoints = 256;
+            int numFailed = 0, numChecked = 0;
+            double worstDecibels = 0.0;
+
+            for (auto sampleRate : { 44100.0, 48000.0, 96000.0 })
+            {
+                //log spaced up to just under nyquist, like the editor's curve
+                std::vector<double> frequencies;
+                for (int i = 0; i < numPoints; ++i)
+                    frequencies.push_back(mapToLog10(double(i) / double(numPoints - 1), 10.0, jmin(20000.0, sampleRate * 0.49)));
+
+                MagnitudeResponseEvaluator evaluator;
+                evaluator.prepare(frequencies, sampleRate);
+                std::vector<double> fastDecibels;
+
+                for (auto cutoff : { 50.f, 500.f, 5000.f })
+                    for (int slope = Slope_12; slope <= Slope_48; ++slope)
+                        for (auto lowPass : { false, true })
+                        {
+                            ++numChecked;
+
+                            const auto order = 2 * (slope + 1);
+                            const auto id = String(lowPass ? "lowPass" : "highPass") + "/sr=" + String(roundToInt(sampleRate))
+                                + "/f=" + String(roundToInt(cutoff)) + "/order=" + String(order);
+
+                            Dsp::ButterworthSections sections;
+                            if (lowPass)
+                                Dsp::Butterworth::designLowPass(cutoff, sampleRate, order, sections);
+                            else
+                                Dsp::Butterworth::designHighPass(cutoff, sampleRate, order, sections);
+
+                            const auto designed = lowPass
+                                ? dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(cutoff, sampleRate, order)
+                                : dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(cutoff, sampleRate, order);
+
+                            //the in place path has to match what the JUCE designers would have built
+                            if (!sameCoefficients(sections, designed))
+                            {
+                                std::cout << "FAIL " << id << ": Dsp::Butterworth and FilterDesign coefficients differ" << std::endl;
+                                ++numFailed;
+                                continue;
+                            }
+
+                            evaluator.reset();
+                            for (int i = 0; i < sections.numSections; ++i)
+                                evaluator.addSection(sections[i].data(), sections[i].size());
+                            evaluator.getDecibels(fastDecibels);
+
+                            double worst = 0.0;
+
+                            for (size_t i = 0; i < frequencies.size(); ++i)
+                            {
+                                const auto expected = getButterworthDecibels(frequencies[i], cutoff, sampleRate, order, lowPass);
+                                if (expected < tolerance.floorDecibels)
+                                    continue;
+
+                                double magnitude = 1.0;
+                                for (auto& section : designed)
+                                    magnitude *= section->getMagnitudeForFrequency(frequencies[i], sampleRate);
+
+                                worst = jmax(worst, std::abs(Decibels::gainToDecibels(magnitude, -300.0) - expected));
+                                worst = jmax(worst, std::abs(fastDecibels[i] - expected));
+                            }
+
+                            worstDecibels = jmax(worstDecibels, worst);
+
+                            if (worst > tolerance.maxDecibelError)
+                            {
+                                std::cout << "FAIL " << id << ": response is " << worst << " dB off the analytic curve" << std::endl;
+                                ++numFailed;
+                            }
+                        }
+            }
+
+            std::cout << "responses: " << (numChecked - numFailed) << " of " << numChecked << " within tolerance, worst "
+                      << worstDecibels << " dB" << std::endl;
+
+            return numFailed;
+        }
+    private:
+        Tolerance tolerance;
+
+        static constexpr int numSamples = 4096;
+
+        struct RenderCase
+        {
+            String signal;
+            ProcessorSettings settings;
+
+            String getId() const
+            {
+                return signal
+                    + "/low=" + (settings.lowCutBypassed ? String("off") : slopeName(settings.lowCutSlope))
+                    + "/high=" + (settings.highCutBypassed ? String("off") : slopeName(settings.highCutSlope))
+                    + "/drive=" + String(settings.drive, 1);
+            }
+        };
+
+        struct Difference
+        {
+            double maxError = 0.0;
+            double snr = std::numeric_limits<double>::infinity();
+        };
+
+        //every signal, slope pair, bypass pair and drive, at 48 kHz in 512 sample blocks
+        static std::vector<RenderCase> getRenderCases()
+        {
+            std::vector<RenderCase> cases;
+
+            for (auto signal : { "sweep", "impulse", "noise" })
+                for (int slopes = 0; slopes < 16; ++slopes)
+                    for (int bypass = 0; bypass < 4; ++bypass)
+                        for (auto drive : { 1.f, 5.f, 10.f })
+                        {
+                            RenderCase renderCase;
+                            renderCase.signal = signal;
+                            renderCase.settings.lowCutFreq = 200.f;
+                            renderCase.settings.highCutFreq = 5000.f;
+                            renderCase.settings.lowCutSlope = static_cast<Slope>(slopes % 4);
+                            renderCase.settings.highCutSlope = static_cast<Slope>(slopes / 4);
+                            renderCase.settings.lowCutBypassed = (bypass & 1) != 0;
+                            renderCase.settings.highCutBypassed = (bypass & 2) != 0;
+                            renderCase.settings.drive = drive;
+                            cases.push_back(renderCase);
+                        }
+
+            return cases;
+        }
+
+        static void makeSignal(const String& name, AudioBuffer<float>& dest, double sampleRate)
+        {
+            dest.clear();
+            auto* left = dest.getWritePointer(0);
+
+            if (name == "impulse")
+            {
+                left[0] = 1.f;
+            }
+            else if (name == "sweep")
+            {
+                //exponential sine sweep from 20 Hz to 20 kHz
+                const auto duration = numSamples / sampleRate;
+                const auto rate = std::log(20000.0 / 20.0);
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const auto t = i / sampleRate;
+                    const auto phase = MathConstants<double>::twoPi * 20.0 * duration / rate * (std::exp(t / duration * rate) - 1.0);
+                    left[i] = static_cast<float>(0.5 * std::sin(phase));
+                }
+            }
+            else
+            {
+                fillWithNoise(dest, 5);
+            }
+
+            //the right channel is the left one inverted and halved, so a channel mix-up shows
+            dest.copyFrom(1, 0, dest, 0, 0, numSamples);
+            dest.applyGain(1, 0, numSamples, -0.5f);
+        }
+
+        static AudioBuffer<float> render(const RenderCase& renderCase)
+        {
+            const auto& settings = renderCase.settings;
+
+            CourseworkPluginAudioProcessor processor;
+            configure(processor, settings);
+
+            //offline as well, like a bounce
+            processor.setNonRealtime(true);
+            prepare(processor, settings.sampleRate, settings.blockSize);
+
+            AudioBuffer<float> buffer(2, numSamples);
+            makeSignal(renderCase.signal, buffer, settings.sampleRate);
+
+            MidiBuffer midi;
+
+            for (int start = 0; start < numSamples; start += settings.blockSize)
+            {
+                AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, start, jmin(settings.blockSize, numSamples - start));
+                processor.processBlock(block, midi);
+            }
+
+            processor.releaseResources();
+            return buffer;
+        }
+
+        static AudioBuffer<float> renderAutomated(const MidiBuffer& automation, double sampleRate, int blockSize)
+        {
+            CourseworkPluginAudioProcessor processor;
+            processor.setNonRealtime(true);
+            prepare(processor, sampleRate, blockSize);
+
+            AudioBuffer<float> buffer(2, numSamples);
+            makeSignal("noise", buffer, sampleRate);
+
+            MidiBuffer midi;
+
+            for (int start = 0; start < numSamples; start += blockSize)
+            {
+                const auto length = jmin(blockSize, numSamples - start);
+
+                //this block's CCs, moved to block relative positions
+                midi.clear();
+                midi.addEvents(automation, start, length, -start);
+
+                AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, start, length);
+                processor.processBlock(block, midi);
+            }
+
+            processor.releaseResources();
+            return buffer;
+        }
+
+        static Difference compare(const AudioBuffer<float>& reference, const AudioBuffer<float>& result)
+        {
+            Difference difference;
+
+            if (reference.getNumChannels() != result.getNumChannels() || reference.getNumSamples() != result.getNumSamples())
+            {
+                difference.maxError = std::numeric_limits<double>::infinity();
+                difference.snr = -std::numeric_limits<double>::infinity();
+                return difference;
+            }
+
+            double signalPower = 0.0, errorPower = 0.0;
+
+            for (int channel = 0; channel < reference.getNumChannels(); ++channel)
+                for (int i = 0; i < reference.getNumSamples(); ++i)
+                {
+                    const double expected = reference.getSample(channel, i);
+                    const auto error = result.getSample(channel, i) - expected;
+
+                    difference.maxError = jmax(difference.maxError, std::abs(error));
+                    signalPower += expected * expected;
+                    errorPower += error * error;
+                }
+
+            if (errorPower > 0.0)
+                difference.snr = signalPower > 0.0 ? 10.0 * std::log10(signalPower / errorPower) : -std::numeric_limits<double>::infinity();
+
+            return difference;
+        }
+
+        //the magnitude of a bilinear transform Butterworth, the prewarping makes it exact at every frequency
+        static double getButterworthDecibels(double frequency, double cutoff, double sampleRate, int order, bool lowPass)
+        {
+            const auto ratio = std::tan(MathConstants<double>::pi * frequency / sampleRate)
+                             / std::tan(MathConstants<double>::pi * cutoff / sampleRate);
+
+            const auto power = 1.0 / (1.0 + std::pow(lowPass ? ratio : 1.0 / ratio, 2.0 * order));
+            return 10.0 * std::log10(power);
+        }
+
+        template<typename CoefficientArray>
+        static bool sameCoefficients(const Dsp::ButterworthSections& sections, const CoefficientArray& designed)
+        {
+            if (sections.numSections != designed.size())
+                return false;
+
+            for (int i = 0; i < sections.numSections; ++i)
+            {
+                const auto* raw = designed[i]->getRawCoefficients();
+                if (designed[i]->coefficients.size() != static_cast<int>(sections[i].size()))
+                    return false;
+
+                for (size_t c = 0; c < sections[i].size(); ++c)
+                    if (std::abs(raw[c] - sections[i][c]) > 1.0e-6f * jmax(1.f, std::abs(raw[c])))
+                        return false;
+            }
+
+            return true;
+        }
+
+        static File getGoldenFile(const File& goldenDirectory, const RenderCase& renderCase)
+        {
+            return goldenDirectory.getChildFile(renderCase.getId().replaceCharacter('=', '-') + ".wav");
+        }
+
+        static bool writeWav(const File& file, const AudioBuffer<float>& buffer, double sampleRate)
+        {
+            if (!file.getParentDirectory().createDirectory() || !file.deleteFile())
+                return false;
+
+            std::unique_ptr<OutputStream> stream(file.createOutputStream());
+            if (stream == nullptr)
+                return false;
+
+            //32 bit wavs are written as floats, so nothing is lost
+            WavAudioFormat format;
+            std::unique_ptr<AudioFormatWriter> writer(format.createWriterFor(stream.get(), sampleRate, (unsigned int)buffer.getNumChannels(), 32, {}, 0));
+            if (writer == nullptr)
+                return false;
+
+            stream.release();
+            return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+        }
+
+        static bool readWav(const File& file, AudioBuffer<float>& dest)
+        {
+            if (!file.existsAsFile())
+                return false;
+
+            WavAudioFormat format;
+            std::unique_ptr<AudioFormatReader> reader(format.createReaderFor(file.createInputStream().release(), true));
+            if (reader == nullptr)
+                return false;
+
+            dest.setSize((int)reader->numChannels, (int)reader->lengthInSamples);
+            return reader->read(&dest, 0, dest.getNumSamples(), 0, true, true);
+        }
+    };
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace Gui
+{
+    using namespace juce;
+
+    /*
+     one frame clock per editor, driven by the display's vblank instead of
+     a timer per visualiser. every client is polled once per frame and only
+     repaints when it has something new.
+
+     the clock skips frames while the editor isn't showing (hidden, minimised
+     or closed), drops to a slower poll when nothing has changed for a while,
+     and divides the vblank rate when painting takes longer than its budget.
+     */
+    class FrameClock
+    {
+    public:
+        struct Client
+        {
+            virtual ~Client() = default;
+
+            //called once per frame, returns true if anything was invalidated
+            virtual bool frameTick() = 0;
+
+            //clients time their own paint() and add it here
+            void notePaintTime(double milliseconds) { paintTime += milliseconds; }
+
+        private:
+            friend class FrameClock;
+            double paintTime = 0.0;
+        };
+
+        explicit FrameClock(Component& ownerToUse) :
+            owner(ownerToUse),
+            vBlankAttachment(&ownerToUse, [this] { onVBlank(); })
+        {
+        }
+
+        void addClient(Client* client) { clients.addIfNotAlreadyThere(client); }
+        void removeClient(Client* client) { clients.removeFirstMatchingValue(client); }
+
+        //how many vblanks pass between two frames, 1 is full rate
+        int getDivider() const { return jmax(loadDivider, idleFrames >= framesBeforeIdle ? idleDivider : 1); }
+
+    private:
+        //average paint time a frame may use before the rate is lowered
+        static constexpr double paintBudgetMs = 6.0;
+        static constexpr int maxLoadDivider = 4;
+
+        //after this many frames without changes the clock polls less often
+        static constexpr int framesBeforeIdle = 30;
+        static constexpr int idleDivider = 4;
+
+        Component& owner;
+        VBlankAttachment vBlankAttachment;
+        Array<Client*> clients;
+
+        int vBlankCount = 0;
+        int loadDivider = 1;
+        int idleFrames = 0;
+        double averagePaintTime = 0.0;
+
+        void onVBlank()
+        {
+            if (++vBlankCount < getDivider())
+                return;
+
+            vBlankCount = 0;
+
+            //isShowing() is false while the window is hidden or minimised
+            if (!owner.isShowing())
+                return;
+
+            updateLoadDivider();
+
+            bool anythingChanged = false;
+
+            for (auto* client : clients)
+                anythingChanged = client->frameTick() || anythingChanged;
+
+            idleFrames = anythingChanged ? 0 : idleFrames + 1;
+        }
+
+        void updateLoadDivider()
+        {
+            //paint time reported since the last frame, smoothed over roughly half a second
+            double paintTime = 0.0;
+            for (auto* client : clients)
+            {
+                paintTime += client->paintTime;
+                client->paintTime = 0.0;
+            }
+
+            averagePaintTime += (paintTime - averagePaintTime) * 0.05;
+
+            //halve the rate quickly when over budget, recover once well under it
+            if (averagePaintTime > paintBudgetMs && loadDivider < maxLoadDivider)
+            {
+                ++loadDivider;
+                averagePaintTime = paintBudgetMs * 0.75;
+            }
+            else if (averagePaintTime < paintBudgetMs * 0.25 && loadDivider > 1)
+            {
+                --loadDivider;
+                averagePaintTime = paintBudgetMs * 0.5;
+            }
+        }
+    };
+
+    //times a paint() call and reports it to the frame clock
+    struct ScopedPaintTimer
+    {
+        explicit ScopedPaintTimer(FrameClock::Client& c) : client(c), start(Time::getMillisecondCounterHiRes()) {}
+        ~ScopedPaintTimer() { client.notePaintTime(Time::getMillisecondCounterHiRes() - start); }
+
+        FrameClock::Client& client;
+        double start;
+    };
+};
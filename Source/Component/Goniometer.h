@@ -0,0 +1,104 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "../DSP/StereoAnalyzer.h"
+
+namespace Gui
+{
+    using namespace juce;
+
+    //vectorscope of the output with a phase correlation bar underneath.
+    //points are drawn into an image that fades a little every frame, so old
+    //points trail off instead of being redrawn
+    class Goniometer : public Component
+    {
+    public:
+        std::function<void()> onClick;
+
+        explicit Goniometer(Dsp::StereoAnalyzer& analyzerToUse) : analyzer(analyzerToUse)
+        {
+            setOpaque(true);
+            newPoints.resize(Dsp::StereoAnalyzer::pointCapacity);
+        }
+
+        //drops points left over from the last time it was shown, call before capture starts again
+        void reset()
+        {
+            while (analyzer.readPoints(newPoints.data(), static_cast<int>(newPoints.size())) > 0) {}
+
+            if (scope.isValid())
+                scope.clear(scope.getBounds());
+
+            correlation = 0.f;
+        }
+
+        //called once per frame while visible
+        bool update()
+        {
+            if (!scope.isValid())
+                return false;
+
+            const auto numPoints = analyzer.readPoints(newPoints.data(), static_cast<int>(newPoints.size()));
+
+            Graphics g(scope);
+            g.fillAll(Colours::black.withAlpha(0.15f));
+
+            //points are scaled so full scale mid or side reaches the edge
+            const auto centre = scope.getBounds().toFloat().getCentre();
+            const auto radius = 0.5f * static_cast<float>(jmin(scope.getWidth(), scope.getHeight()));
+
+            g.setColour(Colours::white.withAlpha(0.6f));
+            for (int i = 0; i < numPoints; ++i)
+            {
+                const auto& p = newPoints[static_cast<size_t>(i)];
+                g.fillRect(centre.x + jlimit(-1.f, 1.f, p.x) * radius, centre.y - jlimit(-1.f, 1.f, p.y) * radius, 1.f, 1.f);
+            }
+
+            correlation = analyzer.getCorrelation();
+            repaint();
+            return true;
+        }
+
+        void paint(Graphics& g) override
+        {
+            auto bounds = getLocalBounds();
+            auto barArea = bounds.removeFromBottom(correlationBarHeight);
+
+            g.fillAll(Colours::black);
+            g.drawImageAt(scope, bounds.getX() + (bounds.getWidth() - scope.getWidth()) / 2, bounds.getY());
+
+            //-1 on the left, +1 on the right, filled from the centre
+            const auto barBounds = barArea.reduced(4, 2).toFloat();
+            const auto centreX = barBounds.getCentreX();
+            const auto x = jmap(correlation, -1.f, 1.f, barBounds.getX(), barBounds.getRight());
+
+            g.setColour(Colours::grey);
+            g.drawVerticalLine(roundToInt(centreX), barBounds.getY(), barBounds.getBottom());
+
+            g.setColour(correlation < 0.f ? Colours::red : Colours::white);
+            g.fillRect(Rectangle<float>::leftTopRightBottom(jmin(centreX, x), barBounds.getY(), jmax(centreX, x), barBounds.getBottom()));
+        }
+
+        void resized() override
+        {
+            //square scope above the correlation bar
+            const auto size = jmax(1, jmin(getWidth(), getHeight() - correlationBarHeight));
+            scope = Image(Image::RGB, size, size, true);
+        }
+
+        void mouseUp(const MouseEvent& e) override
+        {
+            if (onClick && !e.mouseWasDraggedSinceMouseDown())
+                onClick();
+        }
+    private:
+        static constexpr int correlationBarHeight = 10;
+
+        Dsp::StereoAnalyzer& analyzer;
+
+        Image scope;
+        std::vector<Point<float>> newPoints;
+        float correlation = 0.f;
+    };
+};
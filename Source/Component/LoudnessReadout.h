@@ -0,0 +1,57 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace Gui
+{
+    using namespace juce;
+
+    //text readout of the loudness meter, clicking it resets the integrated loudness and true peak
+    class LoudnessReadout : public Component
+    {
+    public:
+        std::function<void()> onReset;
+
+        //returns true if the readout changed and was repainted
+        bool setReadings(float momentary, float shortTerm, float integrated, float truePeak)
+        {
+            //readings are shown to 0.1, anything smaller doesn't need a repaint
+            const std::array<int, 4> rounded
+            {
+                roundToInt(momentary * 10.f), roundToInt(shortTerm * 10.f),
+                roundToInt(integrated * 10.f), roundToInt(truePeak * 10.f)
+            };
+
+            if (rounded == shown)
+                return false;
+
+            shown = rounded;
+            repaint();
+            return true;
+        }
+
+        void paint(Graphics& g) override
+        {
+            g.setColour(Colours::white);
+            g.setFont(11.f);
+
+            auto format = [](int tenths)
+            {
+                //the meter reports -100 until a window has filled
+                return tenths <= -1000 ? String("-inf") : String(tenths / 10.f, 1);
+            };
+
+            g.drawFittedText("M " + format(shown[0]) + "  S " + format(shown[1]) + "  I " + format(shown[2]) + " LUFS"
+                + "  TP " + format(shown[3]) + " dBTP",
+                getLocalBounds(), Justification::centredRight, 1);
+        }
+
+        void mouseDown(const MouseEvent&) override
+        {
+            if (onReset)
+                onReset();
+        }
+    private:
+        std::array<int, 4> shown{ -1000, -1000, -1000, -1000 };
+    };
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "../DSP/Profiler.h"
+
+#if COURSEWORK_ENABLE_PROFILER
+
+namespace Gui
+{
+    using namespace juce;
+
+    //table of the processor's stage timings, shown over the editor with the P key
+    class ProfilerOverlay : public Component
+    {
+    public:
+        explicit ProfilerOverlay(const Dsp::Profiler& profilerToUse) : profiler(profilerToUse)
+        {
+            setInterceptsMouseClicks(false, false);
+        }
+
+        //the histograms are read a few times a second, not every frame
+        bool update()
+        {
+            if (++framesSinceUpdate < framesPerUpdate)
+                return false;
+
+            framesSinceUpdate = 0;
+            repaint();
+            return true;
+        }
+
+        void paint(Graphics& g) override
+        {
+            g.setColour(Colours::black.withAlpha(0.8f));
+            g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.f);
+
+            g.setColour(Colours::white);
+            g.setFont(Font(Font::getDefaultMonospacedFontName(), 11.f, Font::plain));
+
+            auto area = getLocalBounds().reduced(6, 4);
+            auto drawRow = [&area, &g](const String& text)
+            {
+                g.drawText(text, area.removeFromTop(14), Justification::centredLeft, false);
+            };
+
+            auto micros = [](double nanoseconds) { return String(nanoseconds / 1000.0, 1).paddedLeft(' ', 8); };
+
+            drawRow(String("stage").paddedRight(' ', 11) + "p50 us".paddedLeft(' ', 8) + "p99 us".paddedLeft(' ', 8) + "max us".paddedLeft(' ', 8));
+
+            for (int i = 0; i < static_cast<int>(Dsp::ProfileStage::NumStages); ++i)
+            {
+                const auto stage = static_cast<Dsp::ProfileStage>(i);
+                const auto& histogram = profiler.getStage(stage);
+
+                drawRow(String(Dsp::getProfileStageName(stage)).paddedRight(' ', 11)
+                    + micros(histogram.getPercentile(50.0))
+                    + micros(histogram.getPercentile(99.0))
+                    + micros(histogram.getMaximum()));
+            }
+
+            const auto& deadline = profiler.getDeadline();
+            drawRow("deadline p99 " + String(deadline.getPercentile(99.0), 2) + "%  max " + String(deadline.getMaximum(), 2)
+                + "%  misses " + String((int64)profiler.getDeadlineMisses()));
+
+            drawRow("D: dump to file   R: reset");
+        }
+    private:
+        static constexpr int framesPerUpdate = 15;
+
+        const Dsp::Profiler& profiler;
+        int framesSinceUpdate = 0;
+    };
+};
+
+#endif
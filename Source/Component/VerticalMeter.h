@@ -19,11 +19,74 @@ namespace Gui
             g.setColour(Colours::white);
             //map level from -60.f - +6.f to 1 - height
             const auto height = jmap(level, -60.f, +6.f, 0.f, static_cast<float>(getHeight()));
-            g.fillRoundedRectangle(bounds.removeFromBottom(height), 1.f);
+            g.fillRoundedRectangle(bounds.withTop(bounds.getBottom() - jmax(0.f, height)), 1.f);
+
+            //clip indicator at the top
+            if (clipped)
+            {
+                g.setColour(Colours::red);
+                g.fillRoundedRectangle(bounds.removeFromTop(3.f), 1.f);
+            }
+        }
+
+        //returns true if the indicator changed
+        bool setClipped(const bool shouldShowClip)
+        {
+            if (shouldShowClip == clipped)
+                return false;
+
+            clipped = shouldShowClip;
+            repaint();
+            return true;
+        }
+        //returns true if the bar moved and was repainted
+        bool setLevel(const float value)
+        {
+            //only repaint when the bar moves by a visible amount
+            if (std::abs(value - level) < 0.05f)
+                return false;
+
+            level = value;
+            repaint();
+            return true;
         }
-        void setLevel(const float value) { level = value; }
     private:
         float level = -60.f;
+        bool clipped = false;
+
+    };
+
+    //meter ballistics, run on the message thread so the audio thread does no smoothing
+    struct MeterBallistics
+    {
+        //rises instantly, falls most of the way to a lower level in about half a second
+        float process(float target, float seconds)
+        {
+            if (target >= level)
+                level = target;
+            else
+                level += (target - level) * (1.f - std::exp(-seconds / releaseTime));
+
+            return level;
+        }
+
+        //holds the clip indicator for a second after the clip count moves
+        bool processClips(uint32 clipCount, float seconds)
+        {
+            if (clipCount > lastClipCount)
+                clipHold = 1.f;
+            else
+                clipHold = jmax(0.f, clipHold - seconds);
+
+            lastClipCount = clipCount;
+            return clipHold > 0.f;
+        }
+
+    private:
+        static constexpr float releaseTime = 0.5f / 3.f;
 
+        float level = -100.f;
+        uint32 lastClipCount = 0;
+        float clipHold = 0.f;
     };
 };
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "../DSP/WaveformCapture.h"
+
+namespace Gui
+{
+    using namespace juce;
+
+    //draws the processor's waveform capture, one lane per channel.
+    //the mouse wheel zooms out from the default window to minutes of history,
+    //alt-click goes back to the default
+    class WaveformView : public Component
+    {
+    public:
+        std::function<void()> onClick;
+
+        //about the same window the old AudioVisualiserComponent showed (512 blocks of 8 samples)
+        static constexpr int64 defaultSpan = 4096;
+        static constexpr int64 minSpan = 512;
+
+        explicit WaveformView(const Dsp::WaveformCapture& captureToUse) : capture(captureToUse)
+        {
+            setOpaque(true);
+        }
+
+        //called once per frame, repaints when anything new was captured
+        bool update()
+        {
+            const auto written = capture.getNumWritten(0);
+            if (written == lastWritten)
+                return false;
+
+            lastWritten = written;
+            repaint();
+            return true;
+        }
+
+        void paint(Graphics& g) override
+        {
+            g.fillAll(Colours::black);
+            g.setColour(Colours::white);
+
+            auto bounds = getLocalBounds().toFloat();
+            const auto laneHeight = bounds.getHeight() / Dsp::WaveformCapture::numChannels;
+
+            for (int ch = 0; ch < Dsp::WaveformCapture::numChannels; ++ch)
+            {
+                const auto lane = bounds.removeFromTop(laneHeight);
+                const auto numColumns = static_cast<int>(columns.size());
+                const auto filled = capture.read(ch, span, columns.data(), numColumns);
+
+                if (filled == 0)
+                    continue;
+
+                //top edge left to right, then the bottom edge back, one vertex per column
+                const auto first = numColumns - filled;
+                const auto centre = lane.getCentreY();
+                const auto halfHeight = lane.getHeight() * 0.5f;
+                auto toY = [=](float level) { return centre - jlimit(-1.f, 1.f, level) * halfHeight; };
+
+                path.clear();
+                path.startNewSubPath(lane.getX() + first, toY(columns[static_cast<size_t>(first)].max));
+                for (int x = first + 1; x < numColumns; ++x)
+                    path.lineTo(lane.getX() + x, toY(columns[static_cast<size_t>(x)].max));
+                for (int x = numColumns - 1; x >= first; --x)
+                    path.lineTo(lane.getX() + x, toY(columns[static_cast<size_t>(x)].min));
+                path.closeSubPath();
+
+                g.fillPath(path);
+            }
+        }
+
+        void resized() override
+        {
+            //one column per pixel, so drawing is O(width) at any zoom
+            columns.resize(static_cast<size_t>(jmax(1, getWidth())));
+            path.preallocateSpace(getWidth() * 2 * 3 + 8);
+        }
+
+        void mouseWheelMove(const MouseEvent&, const MouseWheelDetails& wheel) override
+        {
+            //zooms by a fraction of an octave per notch
+            const auto factor = std::exp2(-wheel.deltaY * 4.f);
+            span = jlimit<int64>(minSpan, Dsp::WaveformCapture::getMaxSpan(), static_cast<int64>(static_cast<double>(span) * factor));
+            repaint();
+        }
+
+        void mouseUp(const MouseEvent& e) override
+        {
+            if (e.mouseWasDraggedSinceMouseDown())
+                return;
+
+            if (e.mods.isAltDown())
+            {
+                span = defaultSpan;
+                repaint();
+            }
+            else if (onClick)
+            {
+                onClick();
+            }
+        }
+
+        int64 getSpan() const { return span; }
+    private:
+        const Dsp::WaveformCapture& capture;
+
+        int64 span = defaultSpan;
+        int64 lastWritten = -1;
+
+        std::vector<Dsp::WaveformCapture::MinMax> columns;
+        Path path;
+    };
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+
+namespace Dsp
+{
+    using namespace juce;
+
+    //b0 b1 b2 a1 a2 of one biquad, a0 normalised to 1, the layout of juce::dsp::IIR::Coefficients
+    using BiquadCoefficients = std::array<float, 5>;
+
+    //the sections of an even order Butterworth cut, up to the 48 dB/Oct slope
+    struct ButterworthSections
+    {
+        static constexpr int maxSections = 4;
+
+        const BiquadCoefficients& operator[](int index) const { return sections[static_cast<size_t>(index)]; }
+
+        std::array<BiquadCoefficients, maxSections> sections{};
+        int numSections = 0;
+    };
+
+    /*
+     allocation free versions of FilterDesign's high order Butterworth designs
+     for even orders. the maths and the float rounding are the same as
+     designIIRHighpassHighOrderButterworthMethod and
+     designIIRLowpassHighOrderButterworthMethod with IIR::Coefficients'
+     makeHighPass and makeLowPass, so the sections come out identical, they're
+     just written into a fixed array instead of new reference counted objects.
+     */
+    struct Butterworth
+    {
+        static void designHighPass(float frequency, double sampleRate, int order, ButterworthSections& dest)
+        {
+            design(frequency, sampleRate, order, false, dest);
+        }
+
+        static void designLowPass(float frequency, double sampleRate, int order, ButterworthSections& dest)
+        {
+            design(frequency, sampleRate, order, true, dest);
+        }
+
+        //Q of section i of an even order Butterworth cascade
+        static float getSectionQ(int order, int section)
+        {
+            return static_cast<float>(1.0 / (2.0 * std::cos((2.0 * section + 1.0) * MathConstants<double>::pi / (order * 2.0))));
+        }
+    private:
+        static void design(float frequency, double sampleRate, int order, bool lowPass, ButterworthSections& dest)
+        {
+            jassert(sampleRate > 0.0);
+            jassert(frequency > 0.f && frequency <= sampleRate * 0.5);
+            jassert(order > 0 && order % 2 == 0 && order / 2 <= ButterworthSections::maxSections);
+
+            dest.numSections = jmin(order / 2, ButterworthSections::maxSections);
+
+            //the prewarped cutoff is the same for every section
+            const auto tangent = std::tan(MathConstants<float>::pi * frequency / static_cast<float>(sampleRate));
+            const auto n = lowPass ? 1.f / tangent : tangent;
+            const auto nSquared = n * n;
+
+            for (int i = 0; i < dest.numSections; ++i)
+            {
+                const auto invQ = 1.f / getSectionQ(order, i);
+                const auto c1 = 1.f / (1.f + invQ * n + nSquared);
+
+                auto& section = dest.sections[static_cast<size_t>(i)];
+                section[0] = c1;
+                section[1] = c1 * (lowPass ? 2.f : -2.f);
+                section[2] = c1;
+                section[3] = c1 * 2.f * (lowPass ? 1.f - nSquared : nSquared - 1.f);
+                section[4] = c1 * (1.f - invQ * n + nSquared);
+            }
+        }
+    };
+};
@@ -0,0 +1,361 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+
+namespace Dsp
+{
+    using namespace juce;
+
+    /*
+     ITU-R BS.1770 loudness and true peak of a stereo signal, run on the audio thread.
+
+     both channels go through the K-weighting filters together, one channel per
+     lane of a SIMDRegister<double>. the weighted energy is summed in 100 ms
+     blocks, and the momentary (400 ms) and short-term (3 s) windows are running
+     sums over the last 4 and 30 blocks.
+
+     every 400 ms window is also a gating block for the integrated loudness. the
+     blocks go into a 0.01 LU histogram between -70 and +5 LUFS that keeps the
+     exact energy and count of every bin in Fenwick trees, so the gated mean can be
+     found in O(log n) at any time, and an hour long programme needs no more
+     memory than a second.
+
+     true peak is measured by 4x polyphase interpolation (48 taps, 12 per phase).
+
+     readings are published through atomics, the editor can read them at any time.
+     */
+    class LoudnessMeter
+    {
+    public:
+        static constexpr float negativeInfinity = -100.f;
+
+        LoudnessMeter()
+        {
+            designInterpolator();
+
+            energyTree.resize(numHistogramBins + 1);
+            countTree.resize(numHistogramBins + 1);
+        }
+
+        //message or audio thread, before processing starts
+        void prepare(double newSampleRate)
+        {
+            sampleRate = newSampleRate;
+            blockLength = jmax(1, roundToInt(sampleRate / 10.0));
+
+            designKWeighting();
+            reset();
+        }
+
+        //forgets the momentary and short-term history, integrated and true peak are kept
+        void restart()
+        {
+            for (auto& stage : kWeighting)
+                stage.reset();
+
+            blockEnergies.fill(0.0);
+            blocksWritten = 0;
+            blockPosition = 0;
+            blockEnergy = Vec::expand(0.0);
+            momentarySum = shortTermSum = 0.0;
+
+            for (auto& channel : peakHistory)
+                channel.fill(0.f);
+            peakHistoryIndex.fill(0);
+
+            momentary.store(negativeInfinity);
+            shortTerm.store(negativeInfinity);
+        }
+
+        //forgets everything
+        void reset()
+        {
+            restart();
+
+            std::fill(energyTree.begin(), energyTree.end(), 0.0);
+            std::fill(countTree.begin(), countTree.end(), 0);
+            gatedEnergy = 0.0;
+            gatedCount = 0;
+            truePeakMax = 0.f;
+
+            integrated.store(negativeInfinity);
+            truePeak.store(negativeInfinity);
+        }
+
+        //any thread, the integrated reading and true peak start again on the next block
+        void requestReset() { resetRequested.store(true); }
+
+        //without interpolation the true peak reading falls back to the sample peak, which is much cheaper
+        void process(const AudioBuffer<float>& buffer, bool interpolateTruePeak = true)
+        {
+            if (resetRequested.exchange(false))
+                reset();
+
+            const auto numSamples = buffer.getNumSamples();
+            const auto* left = buffer.getReadPointer(0);
+            const auto* right = buffer.getNumChannels() > 1 ? buffer.getReadPointer(1) : nullptr;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                //left in lane 0, right in lane 1, a mono input leaves lane 1 silent
+                alignas(16) double frame[Vec::SIMDNumElements] = {};
+                frame[0] = left[i];
+                if (right != nullptr && Vec::SIMDNumElements > 1)
+                    frame[1] = right[i];
+
+                auto x = Vec::fromRawArray(frame);
+                for (auto& stage : kWeighting)
+                    x = stage.process(x);
+
+                blockEnergy += x * x;
+
+                if (++blockPosition == blockLength)
+                    completeBlock();
+            }
+
+            measureTruePeak(left, 0, numSamples, interpolateTruePeak);
+            if (right != nullptr)
+                measureTruePeak(right, 1, numSamples, interpolateTruePeak);
+
+            truePeak.store(truePeakMax > 0.f ? Decibels::gainToDecibels(truePeakMax, negativeInfinity) : negativeInfinity);
+        }
+
+        //LUFS, or negativeInfinity until the window has filled
+        float getMomentary() const { return momentary.load(); }
+        float getShortTerm() const { return shortTerm.load(); }
+        float getIntegrated() const { return integrated.load(); }
+
+        //dBTP, highest since the last reset
+        float getTruePeak() const { return truePeak.load(); }
+
+    private:
+        using Vec = dsp::SIMDRegister<double>;
+
+        //transposed direct form II biquad running both channels at once
+        struct Biquad
+        {
+            Vec b0, b1, b2, a1, a2;
+            Vec s1, s2;
+
+            void setCoefficients(double nb0, double nb1, double nb2, double na1, double na2)
+            {
+                b0 = Vec::expand(nb0); b1 = Vec::expand(nb1); b2 = Vec::expand(nb2); a1 = Vec::expand(na1); a2 = Vec::expand(na2);
+            }
+
+            void reset() { s1 = Vec::expand(0.0); s2 = Vec::expand(0.0); }
+
+            Vec process(Vec x)
+            {
+                const auto y = b0 * x + s1;
+                s1 = b1 * x - a1 * y + s2;
+                s2 = b2 * x - a2 * y;
+                return y;
+            }
+        };
+
+        static constexpr int momentaryBlocks = 4;
+        static constexpr int shortTermBlocks = 30;
+
+        //gating
+        static constexpr double absoluteGate = -70.0;
+        static constexpr double relativeGate = -10.0;
+
+        //integrated histogram, 0.01 LU bins from the absolute gate up to +5 LUFS
+        static constexpr double histogramStep = 0.01;
+        static constexpr int numHistogramBins = 7500;
+
+        //true peak interpolator
+        static constexpr int oversampling = 4;
+        static constexpr int tapsPerPhase = 12;
+
+        double sampleRate = 48000.0;
+        int blockLength = 4800;
+
+        std::array<Biquad, 2> kWeighting;
+
+        //energy of the block being summed, per channel lane
+        Vec blockEnergy;
+        int blockPosition = 0;
+
+        //energy of the last 30 complete blocks, summed over both channels
+        std::array<double, shortTermBlocks> blockEnergies{};
+        int64 blocksWritten = 0;
+        double momentarySum = 0.0, shortTermSum = 0.0;
+
+        //Fenwick trees over the histogram bins
+        std::vector<double> energyTree;
+        std::vector<int64> countTree;
+        double gatedEnergy = 0.0;
+        int64 gatedCount = 0;
+
+        std::array<std::array<float, tapsPerPhase>, oversampling> phases;
+        std::array<std::array<float, tapsPerPhase * 2>, 2> peakHistory{};
+        std::array<int, 2> peakHistoryIndex{};
+        float truePeakMax = 0.f;
+
+        std::atomic<float> momentary{ negativeInfinity }, shortTerm{ negativeInfinity },
+            integrated{ negativeInfinity }, truePeak{ negativeInfinity };
+        std::atomic<bool> resetRequested{ false };
+
+        static double energyToLoudness(double meanSquare)
+        {
+            return meanSquare > 0.0 ? -0.691 + 10.0 * std::log10(meanSquare) : double(negativeInfinity);
+        }
+
+        //the pre-filter shelf and the RLB highpass, recalculated for any sample rate
+        void designKWeighting()
+        {
+            {
+                const auto f0 = 1681.974450955533;
+                const auto gain = 3.999843853973347;
+                const auto q = 0.7071752369554196;
+
+                const auto k = std::tan(MathConstants<double>::pi * f0 / sampleRate);
+                const auto vh = std::pow(10.0, gain / 20.0);
+                const auto vb = std::pow(vh, 0.4996667741545416);
+                const auto a0 = 1.0 + k / q + k * k;
+
+                kWeighting[0].setCoefficients((vh + vb * k / q + k * k) / a0,
+                    2.0 * (k * k - vh) / a0,
+                    (vh - vb * k / q + k * k) / a0,
+                    2.0 * (k * k - 1.0) / a0,
+                    (1.0 - k / q + k * k) / a0);
+            }
+
+            {
+                const auto f0 = 38.13547087602444;
+                const auto q = 0.5003270373238773;
+
+                const auto k = std::tan(MathConstants<double>::pi * f0 / sampleRate);
+                const auto a0 = 1.0 + k / q + k * k;
+
+                kWeighting[1].setCoefficients(1.0, -2.0, 1.0,
+                    2.0 * (k * k - 1.0) / a0,
+                    (1.0 - k / q + k * k) / a0);
+            }
+        }
+
+        //windowed sinc lowpass at the original nyquist, split into 4 phases of 12 taps
+        void designInterpolator()
+        {
+            constexpr auto numTaps = oversampling * tapsPerPhase;
+            const auto centre = (numTaps - 1) * 0.5;
+
+            for (int n = 0; n < numTaps; ++n)
+            {
+                const auto t = (n - centre) / double(oversampling);
+                const auto sinc = t == 0.0 ? 1.0 : std::sin(MathConstants<double>::pi * t) / (MathConstants<double>::pi * t);
+                const auto window = 0.42 - 0.5 * std::cos(MathConstants<double>::twoPi * n / (numTaps - 1))
+                    + 0.08 * std::cos(2.0 * MathConstants<double>::twoPi * n / (numTaps - 1));
+
+                //taps are reversed to line up with the history, which runs oldest to newest
+                phases[n % oversampling][tapsPerPhase - 1 - n / oversampling] = float(sinc * window);
+            }
+        }
+
+        void measureTruePeak(const float* samples, int channel, int numSamples, bool interpolate)
+        {
+            auto& history = peakHistory[channel];
+            auto& index = peakHistoryIndex[channel];
+            auto peak = truePeakMax;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                //the history is written twice so the last 12 samples are always contiguous
+                index = (index + 1) % tapsPerPhase;
+                history[index] = history[index + tapsPerPhase] = samples[i];
+
+                if (!interpolate)
+                {
+                    peak = jmax(peak, std::abs(samples[i]));
+                    continue;
+                }
+
+                const auto* recent = history.data() + index + 1;
+
+                for (const auto& phase : phases)
+                {
+                    float sum = 0.f;
+                    for (int k = 0; k < tapsPerPhase; ++k)
+                        sum += phase[k] * recent[k];
+
+                    peak = jmax(peak, std::abs(sum));
+                }
+            }
+
+            truePeakMax = peak;
+        }
+
+        void completeBlock()
+        {
+            double lanes[Vec::SIMDNumElements];
+            blockEnergy.copyToRawArray(lanes);
+
+            double energy = 0.0;
+            for (auto lane : lanes)
+                energy += lane;
+
+            blockEnergy = Vec::expand(0.0);
+            blockPosition = 0;
+
+            //running sums over the last 4 and 30 blocks
+            const auto slot = static_cast<size_t>(blocksWritten % shortTermBlocks);
+            const auto momentaryOldest = static_cast<size_t>((blocksWritten + shortTermBlocks - momentaryBlocks) % shortTermBlocks);
+
+            if (blocksWritten >= momentaryBlocks)
+                momentarySum -= blockEnergies[momentaryOldest];
+            if (blocksWritten >= shortTermBlocks)
+                shortTermSum -= blockEnergies[slot];
+
+            blockEnergies[slot] = energy;
+            momentarySum = jmax(0.0, momentarySum + energy);
+            shortTermSum = jmax(0.0, shortTermSum + energy);
+            ++blocksWritten;
+
+            if (blocksWritten >= momentaryBlocks)
+            {
+                const auto momentaryLoudness = energyToLoudness(momentarySum / (momentaryBlocks * blockLength));
+                momentary.store(float(momentaryLoudness));
+
+                //every 400 ms window, overlapping by 75%, is a gating block
+                addGatingBlock(momentarySum / (momentaryBlocks * blockLength), momentaryLoudness);
+            }
+
+            if (blocksWritten >= shortTermBlocks)
+                shortTerm.store(float(energyToLoudness(shortTermSum / (shortTermBlocks * blockLength))));
+        }
+
+        void addGatingBlock(double meanSquare, double loudness)
+        {
+            if (loudness < absoluteGate)
+                return;
+
+            const auto bin = jlimit(0, numHistogramBins - 1, (int)((loudness - absoluteGate) / histogramStep));
+            for (auto i = bin + 1; i <= numHistogramBins; i += i & -i)
+            {
+                energyTree[static_cast<size_t>(i)] += meanSquare;
+                ++countTree[static_cast<size_t>(i)];
+            }
+
+            gatedEnergy += meanSquare;
+            ++gatedCount;
+
+            //blocks more than 10 LU below the mean of everything above the absolute gate are dropped
+            const auto threshold = energyToLoudness(gatedEnergy / double(gatedCount)) + relativeGate;
+            const auto thresholdBin = jlimit(0, numHistogramBins, (int)std::ceil((threshold - absoluteGate) / histogramStep));
+
+            double belowEnergy = 0.0;
+            int64 belowCount = 0;
+            for (auto i = thresholdBin; i > 0; i -= i & -i)
+            {
+                belowEnergy += energyTree[static_cast<size_t>(i)];
+                belowCount += countTree[static_cast<size_t>(i)];
+            }
+
+            const auto count = gatedCount - belowCount;
+            integrated.store(count > 0 ? float(energyToLoudness((gatedEnergy - belowEnergy) / double(count))) : negativeInfinity);
+        }
+    };
+};
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "../Parameters.h"
+
+#include <array>
+
+namespace Dsp
+{
+    using namespace juce;
+
+    /*
+     sample accurate automation from MIDI CCs.
+
+     each target is a parameter with a controller number. at the start of a
+     block the parameter snapshot gets every target's value and processBlock
+     gets the block's CCs as timestamped events, so it can split the block
+     where they land instead of applying them a whole block late or early.
+
+     CCs are also queued for the message thread, which writes them into the
+     parameters so the host and the editor follow, and acknowledges the
+     latest CC of each target once it has. until then the CC's value wins
+     over the parameter, so the audio never depends on when the message
+     thread gets round to it and offline renders come out the same at any
+     block size. after that the parameter speaks for itself again, even if
+     host automation has moved it on from the CC's value. a CC the queue
+     has no room for gives the parameter back straight away, since it would
+     never be acknowledged.
+     */
+    class MidiAutomation
+    {
+    public:
+        static constexpr int maxTargets = 16;
+
+        //CCs past this in one block still land, at the start of the next block
+        static constexpr int maxEventsPerBlock = 512;
+
+        struct Event
+        {
+            int sample = 0;
+            Params::Id target = Params::NumParameters;
+
+            //plain value in the parameter's own range, like getRawParameterValue()
+            float value = 0.f;
+        };
+
+        //message thread, before processing starts
+        void addTarget(int controller, Params::Id id, RangedAudioParameter& parameter)
+        {
+            jassert(numTargets < maxTargets);
+
+            auto& target = targets[static_cast<size_t>(numTargets++)];
+            target.controller = controller;
+            target.id = id;
+            target.parameter = &parameter;
+        }
+
+        //audio thread, once at the start of every block, after the snapshot has read the parameters
+        void beginBlock(const MidiBuffer& midi, int numSamples, Params::Snapshot& snapshot)
+        {
+            numEvents = 0;
+
+            for (int i = 0; i < numTargets; ++i)
+            {
+                auto& target = targets[static_cast<size_t>(i)];
+
+                if (!target.pending)
+                    continue;
+
+                //the snapshot was read before this, so it may have missed the write the acknowledgement
+                //stands for. the CC covers this block too, the next snapshot has the parameter's value
+                if (target.acknowledged.load() == target.pendingSequence)
+                    target.pending = false;
+
+                snapshot.set(target.id, target.pendingValue);
+            }
+
+            for (const auto metadata : midi)
+            {
+                const auto message = metadata.getMessage();
+                if (!message.isController())
+                    continue;
+
+                const auto index = findTarget(message.getControllerNumber());
+                if (index < 0)
+                    continue;
+
+                auto& target = targets[static_cast<size_t>(index)];
+                const auto normalised = message.getControllerValue() / 127.f;
+                const auto value = target.parameter->convertFrom0to1(normalised);
+
+                if (numEvents < maxEventsPerBlock)
+                    events[static_cast<size_t>(numEvents++)] = { jlimit(0, numSamples, metadata.samplePosition), target.id, value };
+
+                //if the queue is full the parameter misses this one. the audio still has it for the rest
+                //of the block, then follows the parameter rather than a CC the host will never see
+                const auto scope = changes.write(1);
+                if (scope.blockSize1 > 0)
+                {
+                    target.pending = true;
+                    target.pendingValue = value;
+                    target.pendingSequence = ++target.sequence;
+
+                    changeBuffer[static_cast<size_t>(scope.startIndex1)] = { index, normalised, target.pendingSequence };
+                }
+                else
+                {
+                    target.pending = false;
+                }
+            }
+        }
+
+        //audio thread, this block's events in time order
+        int getNumEvents() const { return numEvents; }
+        const Event& getEvent(int index) const { return events[static_cast<size_t>(index)]; }
+
+        //message thread, writes the queued CCs into their parameters
+        void applyToParameters()
+        {
+            const auto scope = changes.read(changes.getNumReady());
+
+            auto apply = [this](int start, int size)
+            {
+                for (int i = start; i < start + size; ++i)
+                {
+                    const auto& change = changeBuffer[static_cast<size_t>(i)];
+                    auto& target = targets[static_cast<size_t>(change.target)];
+
+                    target.parameter->setValueNotifyingHost(change.normalised);
+                    target.acknowledged.store(change.sequence);
+                }
+            };
+
+            apply(scope.startIndex1, scope.blockSize1);
+            apply(scope.startIndex2, scope.blockSize2);
+        }
+    private:
+        struct Target
+        {
+            int controller = -1;
+            Params::Id id = Params::NumParameters;
+            RangedAudioParameter* parameter = nullptr;
+
+            //audio thread only. every queued CC gets the next sequence number
+            float pendingValue = 0.f;
+            bool pending = false;
+            uint32 sequence = 0, pendingSequence = 0;
+
+            //the sequence number of the last CC the message thread wrote into the parameter
+            std::atomic<uint32> acknowledged{ 0 };
+        };
+
+        struct Change
+        {
+            int target = 0;
+            float normalised = 0.f;
+            uint32 sequence = 0;
+        };
+
+        std::array<Target, maxTargets> targets;
+        int numTargets = 0;
+
+        std::array<Event, maxEventsPerBlock> events;
+        int numEvents = 0;
+
+        static constexpr int changeCapacity = 1024;
+        std::array<Change, changeCapacity> changeBuffer;
+        AbstractFifo changes{ changeCapacity };
+
+        int findTarget(int controller) const
+        {
+            for (int i = 0; i < numTargets; ++i)
+                if (targets[static_cast<size_t>(i)].controller == controller)
+                    return i;
+
+            return -1;
+        }
+    };
+};
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <chrono>
+
+/*
+ per stage timing of processBlock. on by default in debug builds, define
+ COURSEWORK_ENABLE_PROFILER=1 in the exporter's preprocessor definitions to
+ get it in a release build too. when it's 0 the macros expand to nothing and
+ the profiler isn't part of the processor or the editor at all.
+ */
+#ifndef COURSEWORK_ENABLE_PROFILER
+ #if JUCE_DEBUG
+  #define COURSEWORK_ENABLE_PROFILER 1
+ #else
+  #define COURSEWORK_ENABLE_PROFILER 0
+ #endif
+#endif
+
+namespace Dsp
+{
+    using namespace juce;
+
+    enum class ProfileStage
+    {
+        Filters,
+        Waveshaper,
+        Capture,
+        Metering,
+        Block,
+        NumStages
+    };
+
+    inline const char* getProfileStageName(ProfileStage stage)
+    {
+        switch (stage)
+        {
+            case ProfileStage::Filters:     return "filters";
+            case ProfileStage::Waveshaper:  return "waveshaper";
+            case ProfileStage::Capture:     return "capture";
+            case ProfileStage::Metering:    return "metering";
+            case ProfileStage::Block:       return "block";
+            default:                        return "";
+        }
+    }
+
+    /*
+     lock-free histogram of durations with 4 bins per octave over 32 octaves,
+     from 1 ns up to about 4 s unless the first bin starts somewhere else.
+     the audio thread is the only writer, so every counter is a relaxed load
+     and store, readers on other threads see counts that are at most a block
+     behind.
+     */
+    class DurationHistogram
+    {
+    public:
+        static constexpr int binsPerOctave = 4;
+        static constexpr int numBins = 32 * binsPerOctave;
+
+        //values at or under lowest all land in the first bin
+        explicit DurationHistogram(double lowestValue = 1.0) : lowest(lowestValue) {}
+
+        //writer only
+        void add(double nanoseconds)
+        {
+            const auto bin = jlimit(0, numBins - 1, (int)(std::log2(jmax(1.0, nanoseconds / lowest)) * binsPerOctave));
+            bins[bin].store(bins[bin].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+            if (nanoseconds > maximum.load(std::memory_order_relaxed))
+                maximum.store(nanoseconds, std::memory_order_relaxed);
+        }
+
+        //writer only
+        void reset()
+        {
+            for (auto& bin : bins)
+                bin.store(0, std::memory_order_relaxed);
+
+            count.store(0, std::memory_order_relaxed);
+            maximum.store(0.0, std::memory_order_relaxed);
+        }
+
+        //any thread, the upper edge of the bin the percentile falls in
+        double getPercentile(double percentile) const
+        {
+            const auto total = count.load(std::memory_order_relaxed);
+            if (total == 0)
+                return 0.0;
+
+            const auto target = (uint64)std::ceil(total * percentile / 100.0);
+            uint64 seen = 0;
+
+            for (int i = 0; i < numBins; ++i)
+            {
+                seen += bins[i].load(std::memory_order_relaxed);
+                if (seen >= target)
+                    return lowest * std::exp2(double(i + 1) / binsPerOctave);
+            }
+
+            return getMaximum();
+        }
+
+        double getMaximum() const { return maximum.load(std::memory_order_relaxed); }
+        uint64 getCount() const { return count.load(std::memory_order_relaxed); }
+    private:
+        double lowest;
+        std::array<std::atomic<uint64>, numBins> bins{};
+        std::atomic<uint64> count{ 0 };
+        std::atomic<double> maximum{ 0.0 };
+    };
+
+    class Profiler
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        //times one stage for as long as it's in scope
+        struct ScopedStage
+        {
+            ScopedStage(Profiler& p, ProfileStage s) : profiler(p), stage(s), start(Clock::now()) {}
+            ~ScopedStage() { profiler.addStageTime(stage, std::chrono::duration<double, std::nano>(Clock::now() - start).count()); }
+
+            Profiler& profiler;
+            ProfileStage stage;
+            Clock::time_point start;
+        };
+
+        //audio thread, at the start of every block
+        void beginBlock()
+        {
+            if (resetRequested.exchange(false))
+            {
+                for (auto& histogram : stages)
+                    histogram.reset();
+
+                deadline.reset();
+                deadlineMisses.store(0, std::memory_order_relaxed);
+            }
+
+            blockTotals.fill(-1.0);
+            blockStart = Clock::now();
+        }
+
+        //audio thread, at the end of every block
+        void endBlock(int numSamples, double sampleRate)
+        {
+            const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - blockStart).count();
+            addStageTime(ProfileStage::Block, elapsed);
+
+            //a stage can be timed in several places, each histogram gets its total for the block
+            for (size_t i = 0; i < stages.size(); ++i)
+                if (blockTotals[i] >= 0.0)
+                    stages[i].add(blockTotals[i]);
+
+            //the fraction of the time the block represents that it took to process, in percent
+            if (sampleRate > 0.0 && numSamples > 0)
+            {
+                const auto budget = numSamples / sampleRate * 1.0e9;
+                const auto used = 100.0 * elapsed / budget;
+
+                deadline.add(used);
+
+                if (used >= 100.0)
+                    deadlineMisses.store(deadlineMisses.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        }
+
+        //audio thread, adds to the stage's total for this block
+        void addStageTime(ProfileStage stage, double nanoseconds)
+        {
+            auto& total = blockTotals[static_cast<size_t>(stage)];
+            total = jmax(0.0, total) + nanoseconds;
+        }
+
+        //any thread
+        void requestReset() { resetRequested.store(true); }
+
+        const DurationHistogram& getStage(ProfileStage stage) const { return stages[static_cast<size_t>(stage)]; }
+
+        //percent of the buffer deadline used, in the same kind of log histogram starting at 0.01%
+        const DurationHistogram& getDeadline() const { return deadline; }
+        uint64 getDeadlineMisses() const { return deadlineMisses.load(std::memory_order_relaxed); }
+
+        //p50, p99 and max of every stage and the deadline use, as JSON
+        String createReport() const
+        {
+            auto* root = new DynamicObject();
+
+            for (int i = 0; i < static_cast<int>(ProfileStage::NumStages); ++i)
+            {
+                const auto& histogram = stages[static_cast<size_t>(i)];
+
+                auto* stage = new DynamicObject();
+                stage->setProperty("count", (int64)histogram.getCount());
+                stage->setProperty("p50_ns", histogram.getPercentile(50.0));
+                stage->setProperty("p99_ns", histogram.getPercentile(99.0));
+                stage->setProperty("max_ns", histogram.getMaximum());
+
+                root->setProperty(getProfileStageName(static_cast<ProfileStage>(i)), var(stage));
+            }
+
+            auto* deadlineObject = new DynamicObject();
+            deadlineObject->setProperty("p50_percent", deadline.getPercentile(50.0));
+            deadlineObject->setProperty("p99_percent", deadline.getPercentile(99.0));
+            deadlineObject->setProperty("max_percent", deadline.getMaximum());
+            deadlineObject->setProperty("misses", (int64)getDeadlineMisses());
+            root->setProperty("deadline", var(deadlineObject));
+
+            return JSON::toString(var(root));
+        }
+
+        //writes createReport() to a file, returns false if it couldn't be written
+        bool writeReport(const File& file) const
+        {
+            return file.replaceWithText(createReport());
+        }
+    private:
+        std::array<DurationHistogram, static_cast<size_t>(ProfileStage::NumStages)> stages;
+        //a block usually takes well under 1% of its deadline, so the bins start far below that
+        DurationHistogram deadline{ 0.01 };
+        std::atomic<uint64> deadlineMisses{ 0 };
+        std::atomic<bool> resetRequested{ false };
+
+        Clock::time_point blockStart;
+
+        //time spent in each stage this block, negative for stages that didn't run
+        std::array<double, static_cast<size_t>(ProfileStage::NumStages)> blockTotals{};
+    };
+};
+
+#if COURSEWORK_ENABLE_PROFILER
+ #define COURSEWORK_PROFILE_STAGE(profiler, stage) const Dsp::Profiler::ScopedStage JUCE_JOIN_MACRO(profileStage_, __LINE__) (profiler, Dsp::ProfileStage::stage)
+ #define COURSEWORK_PROFILE_BEGIN_BLOCK(profiler) profiler.beginBlock()
+ #define COURSEWORK_PROFILE_END_BLOCK(profiler, numSamples, sampleRate) profiler.endBlock(numSamples, sampleRate)
+#else
+ #define COURSEWORK_PROFILE_STAGE(profiler, stage)
+ #define COURSEWORK_PROFILE_BEGIN_BLOCK(profiler)
+ #define COURSEWORK_PROFILE_END_BLOCK(profiler, numSamples, sampleRate)
+#endif
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace Dsp
+{
+    using namespace juce;
+
+    //each tier keeps the savings of the ones before it
+    enum class QualityTier
+    {
+        Full,       //everything
+        Reduced,    //the spectrum analyser isn't fed
+        Economy,    //the waveshaper uses a rational tanh approximation
+        Minimal,    //the loudness meter reads sample peak instead of 4x true peak
+        NumTiers
+    };
+
+    /*
+     steps the processor down through the quality tiers when processBlock
+     takes too much of the block's real time budget, and back up once it has
+     stayed well under for a while.
+
+     the load is how long a block took over how long it lasts, smoothed over
+     roughly 100 ms so one slow block doesn't count. it has to stay over
+     stepDownLoad for stepDownSeconds to drop a tier, and under stepUpLoad for
+     the much longer stepUpSeconds to come back, so a tier that fixes the load
+     isn't left straight away. a forced tier overrides the automatic one but
+     the load is still measured.
+     */
+    class QualityGovernor
+    {
+    public:
+        static constexpr double stepDownLoad = 0.6, stepUpLoad = 0.25;
+        static constexpr double stepDownSeconds = 0.25, stepUpSeconds = 3.0;
+        static constexpr double smoothingSeconds = 0.1;
+
+        //audio thread or before processing starts, goes back to full quality
+        void prepare(double newSampleRate)
+        {
+            sampleRate = newSampleRate;
+            smoothedLoad = 0.0;
+            overSeconds = underSeconds = 0.0;
+            automaticTier = QualityTier::Full;
+
+            load.store(0.f);
+            publishTier();
+        }
+
+        //audio thread, -1 leaves the tier to the governor
+        void setForcedTier(int newForcedTier)
+        {
+            forcedTier = jlimit(-1, static_cast<int>(QualityTier::NumTiers) - 1, newForcedTier);
+            publishTier();
+        }
+
+        //audio thread, after every block that ran in real time
+        void addBlock(double elapsedSeconds, int numSamples)
+        {
+            if (sampleRate <= 0.0 || numSamples <= 0)
+                return;
+
+            const auto budget = numSamples / sampleRate;
+            smoothedLoad += (1.0 - std::exp(-budget / smoothingSeconds)) * (elapsedSeconds / budget - smoothedLoad);
+
+            if (smoothedLoad > stepDownLoad)
+            {
+                overSeconds += budget;
+                underSeconds = 0.0;
+            }
+            else if (smoothedLoad < stepUpLoad)
+            {
+                underSeconds += budget;
+                overSeconds = 0.0;
+            }
+            else
+            {
+                overSeconds = underSeconds = 0.0;
+            }
+
+            auto newTier = static_cast<int>(automaticTier);
+
+            if (overSeconds >= stepDownSeconds && newTier < static_cast<int>(QualityTier::Minimal))
+            {
+                ++newTier;
+                overSeconds = 0.0;
+            }
+            else if (underSeconds >= stepUpSeconds && newTier > static_cast<int>(QualityTier::Full))
+            {
+                --newTier;
+                underSeconds = 0.0;
+            }
+
+            automaticTier = static_cast<QualityTier>(newTier);
+
+            load.store(static_cast<float>(smoothedLoad));
+            publishTier();
+        }
+
+        //any thread
+        QualityTier getTier() const { return static_cast<QualityTier>(tier.load()); }
+        float getLoad() const { return load.load(); }
+    private:
+        double sampleRate = 0.0;
+        double smoothedLoad = 0.0;
+        double overSeconds = 0.0, underSeconds = 0.0;
+
+        QualityTier automaticTier = QualityTier::Full;
+        int forcedTier = -1;
+
+        std::atomic<int> tier{ 0 };
+        std::atomic<float> load{ 0.f };
+
+        void publishTier()
+        {
+            tier.store(forcedTier >= 0 ? forcedTier : static_cast<int>(automaticTier));
+        }
+    };
+
+    inline const char* getQualityTierName(QualityTier tier)
+    {
+        switch (tier)
+        {
+            case QualityTier::Full:     return "Full";
+            case QualityTier::Reduced:  return "Reduced";
+            case QualityTier::Economy:  return "Economy";
+            case QualityTier::Minimal:  return "Minimal";
+            default:                    return "";
+        }
+    }
+};
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <atomic>
+#include <cstring>
+
+/*
+ real-time safety checks for the audio thread. off unless
+ COURSEWORK_RT_CHECKS=1 is defined, then processBlock() and the hot paths
+ it calls mark themselves as real-time sections.
+
+ the plugin only marks the sections and keeps the reports. the hooks that
+ notice an allocation, a lock or a blocking call are installed by the test
+ harness (see Benchmarks/Source/RealtimeHooks.cpp), they ask
+ isInRealtimeScope() and call report(). a breakpoint in report() shows
+ where a violation came from.
+ */
+#ifndef COURSEWORK_RT_CHECKS
+ #define COURSEWORK_RT_CHECKS 0
+#endif
+
+namespace Dsp
+{
+    using namespace juce;
+
+    enum class RealtimeViolation
+    {
+        Allocation,
+        Deallocation,
+        Lock,
+        BlockingCall,
+        Overrun,
+        NumKinds
+    };
+
+    inline const char* getRealtimeViolationName(RealtimeViolation kind)
+    {
+        switch (kind)
+        {
+            case RealtimeViolation::Allocation:     return "allocation";
+            case RealtimeViolation::Deallocation:   return "deallocation";
+            case RealtimeViolation::Lock:           return "lock";
+            case RealtimeViolation::BlockingCall:   return "blocking call";
+            case RealtimeViolation::Overrun:        return "overrun";
+            default:                                return "";
+        }
+    }
+
+    class RealtimeGuard
+    {
+    public:
+        static constexpr int maxReports = 64;
+        static constexpr int maxDetailLength = 96;
+
+        struct Report
+        {
+            RealtimeViolation kind = RealtimeViolation::Allocation;
+            const char* scope = "";
+            char detail[maxDetailLength]{};
+        };
+
+        //marks a real-time section on this thread, sections can nest
+        class Scope
+        {
+        public:
+            explicit Scope(const char* name) noexcept : previousName(state().scopeName)
+            {
+                auto& s = state();
+                s.scopeName = name;
+
+                if (s.depth++ == 0)
+                {
+                    activeSince.store(Time::getHighResolutionTicks(), std::memory_order_relaxed);
+                    activeEntry.fetch_add(1, std::memory_order_release);
+                }
+            }
+
+            ~Scope()
+            {
+                auto& s = state();
+                s.scopeName = previousName;
+
+                if (--s.depth == 0)
+                    activeEntry.fetch_add(1, std::memory_order_release);
+            }
+        private:
+            const char* previousName;
+
+            JUCE_DECLARE_NON_COPYABLE(Scope)
+        };
+
+        //stops the hooks reporting on this thread, for the harness's own bookkeeping
+        class ScopedPause
+        {
+        public:
+            ScopedPause() noexcept { ++state().paused; }
+            ~ScopedPause() { --state().paused; }
+
+            JUCE_DECLARE_NON_COPYABLE(ScopedPause)
+        };
+
+        static bool isInRealtimeScope() noexcept
+        {
+            const auto& s = state();
+            return s.depth > 0 && s.paused == 0;
+        }
+
+        static const char* getCurrentScopeName() noexcept { return state().scopeName; }
+
+        //called by the hooks on the offending thread, never allocates or locks
+        static void report(RealtimeViolation kind, const char* detail) noexcept
+        {
+            counts[static_cast<size_t>(kind)].fetch_add(1, std::memory_order_relaxed);
+
+            const auto index = numReports.fetch_add(1, std::memory_order_relaxed);
+            if (index >= maxReports)
+                return;
+
+            auto& entry = reports[static_cast<size_t>(index)];
+            entry.kind = kind;
+            entry.scope = getCurrentScopeName();
+            std::strncpy(entry.detail, detail, maxDetailLength - 1);
+
+            reportsWritten.fetch_add(1, std::memory_order_release);
+        }
+
+        static uint64 getCount(RealtimeViolation kind) { return counts[static_cast<size_t>(kind)].load(std::memory_order_relaxed); }
+
+        static uint64 getTotalCount()
+        {
+            uint64 total = 0;
+            for (auto& count : counts)
+                total += count.load(std::memory_order_relaxed);
+            return total;
+        }
+
+        //the first maxReports violations, only read once the audio thread has stopped
+        static int getNumReports() { return jmin(maxReports, reportsWritten.load(std::memory_order_acquire)); }
+        static const Report& getReport(int index) { return reports[static_cast<size_t>(index)]; }
+
+        static void clear()
+        {
+            for (auto& count : counts)
+                count.store(0);
+
+            numReports.store(0);
+            reportsWritten.store(0);
+        }
+
+        /*
+         for a watchdog thread. the entry count is odd while a section is
+         running, and changes every time one starts or ends, so a watchdog
+         that sees the same odd count for too long has found a stuck thread
+         */
+        static uint64 getActiveEntry() { return activeEntry.load(std::memory_order_acquire); }
+        static int64 getActiveSinceTicks() { return activeSince.load(std::memory_order_relaxed); }
+    private:
+        struct ThreadState
+        {
+            int depth = 0;
+            int paused = 0;
+            const char* scopeName = "";
+        };
+
+        static ThreadState& state() noexcept
+        {
+            static thread_local ThreadState threadState;
+            return threadState;
+        }
+
+        static inline std::array<std::atomic<uint64>, static_cast<size_t>(RealtimeViolation::NumKinds)> counts{};
+        static inline std::array<Report, maxReports> reports{};
+        static inline std::atomic<int> numReports{ 0 }, reportsWritten{ 0 };
+
+        static inline std::atomic<uint64> activeEntry{ 0 };
+        static inline std::atomic<int64> activeSince{ 0 };
+    };
+};
+
+#if COURSEWORK_RT_CHECKS
+ #define COURSEWORK_REALTIME_SCOPE(name) const Dsp::RealtimeGuard::Scope JUCE_JOIN_MACRO(realtimeScope_, __LINE__) (name)
+#else
+ #define COURSEWORK_REALTIME_SCOPE(name)
+#endif
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace Dsp
+{
+    using namespace juce;
+
+    /*
+     phase correlation and goniometer points of the output, captured on the
+     audio thread while the goniometer is visible.
+
+     the per block sums (L*R, L*L and R*R) are accumulated with SIMD registers
+     over aligned copies of the block, then folded into exponentially decaying
+     totals so the correlation reads over roughly the last 300 ms.
+
+     every few samples a point in mid/side coordinates goes into a lock-free
+     ring that the goniometer drains once per frame.
+     */
+    class StereoAnalyzer
+    {
+    public:
+        //one point every 4 samples, about 12000 points a second at 48 kHz
+        static constexpr int decimation = 4;
+        static constexpr int pointCapacity = 8192;
+
+        StereoAnalyzer()
+        {
+            points.resize(pointCapacity);
+        }
+
+        void prepare(double sampleRate, int maximumBlockSize)
+        {
+            blockCapacity = maximumBlockSize;
+            scratch.allocate(2 * paddedSize(maximumBlockSize) + Vec::size(), true);
+            decayTime = 0.3 * sampleRate;
+            restart();
+        }
+
+        //audio thread only
+        void restart()
+        {
+            sumLR = sumLL = sumRR = 0.0;
+            decimationPhase = 0;
+            correlation.store(0.f);
+        }
+
+        //audio thread only
+        void process(const AudioBuffer<float>& buffer)
+        {
+            if (buffer.getNumChannels() < 2)
+                return;
+
+            const auto numSamples = jmin(buffer.getNumSamples(), blockCapacity);
+            const auto* left = buffer.getReadPointer(0);
+            const auto* right = buffer.getReadPointer(1);
+
+            accumulate(left, right, numSamples);
+            pushPoints(left, right, numSamples);
+        }
+
+        //-1 (out of phase) to +1 (mono), 0 when silent or uncorrelated
+        float getCorrelation() const { return correlation.load(); }
+
+        //message thread only, copies up to maxPoints of the oldest points not read yet
+        int readPoints(Point<float>* dest, int maxPoints)
+        {
+            const auto scope = pointFifo.read(jmin(maxPoints, pointFifo.getNumReady()));
+
+            std::copy_n(points.data() + scope.startIndex1, scope.blockSize1, dest);
+            std::copy_n(points.data() + scope.startIndex2, scope.blockSize2, dest + scope.blockSize1);
+
+            return scope.blockSize1 + scope.blockSize2;
+        }
+
+    private:
+        using Vec = dsp::SIMDRegister<float>;
+
+        static int paddedSize(int numSamples)
+        {
+            return (numSamples + (int)Vec::size() - 1) / (int)Vec::size() * (int)Vec::size();
+        }
+
+        HeapBlock<float> scratch;
+        int blockCapacity = 0;
+
+        double decayTime = 0.3 * 48000.0;
+        double sumLR = 0.0, sumLL = 0.0, sumRR = 0.0;
+        std::atomic<float> correlation{ 0.f };
+
+        std::vector<Point<float>> points;
+        AbstractFifo pointFifo{ pointCapacity };
+        int decimationPhase = 0;
+
+        void accumulate(const float* left, const float* right, int numSamples)
+        {
+            //host buffers aren't guaranteed to be aligned, so the block is copied first
+            //and the padding is zeroed so it adds nothing to the sums
+            auto* l = Vec::getNextSIMDAlignedPtr(scratch.get());
+            auto* r = l + paddedSize(blockCapacity);
+            const auto padded = paddedSize(numSamples);
+
+            FloatVectorOperations::copy(l, left, numSamples);
+            FloatVectorOperations::copy(r, right, numSamples);
+            FloatVectorOperations::clear(l + numSamples, padded - numSamples);
+            FloatVectorOperations::clear(r + numSamples, padded - numSamples);
+
+            auto lr = Vec::expand(0.f), ll = Vec::expand(0.f), rr = Vec::expand(0.f);
+
+            for (int i = 0; i < padded; i += (int)Vec::size())
+            {
+                const auto vl = Vec::fromRawArray(l + i);
+                const auto vr = Vec::fromRawArray(r + i);
+
+                lr += vl * vr;
+                ll += vl * vl;
+                rr += vr * vr;
+            }
+
+            //older blocks fade out over about 300 ms
+            const auto decay = std::exp(-numSamples / decayTime);
+            sumLR = sumLR * decay + lr.sum();
+            sumLL = sumLL * decay + ll.sum();
+            sumRR = sumRR * decay + rr.sum();
+
+            const auto energy = std::sqrt(sumLL * sumRR);
+            correlation.store(energy > 1.0e-12 ? float(jlimit(-1.0, 1.0, sumLR / energy)) : 0.f);
+        }
+
+        void pushPoints(const float* left, const float* right, int numSamples)
+        {
+            const auto first = (decimation - decimationPhase) % decimation;
+            const auto numPoints = first < numSamples ? (numSamples - first + decimation - 1) / decimation : 0;
+            decimationPhase = (decimationPhase + numSamples) % decimation;
+
+            //points the goniometer hasn't drawn yet are simply dropped when the ring is full
+            const auto scope = pointFifo.write(jmin(numPoints, pointFifo.getFreeSpace()));
+
+            auto sample = first;
+            auto writePoints = [&](int start, int count)
+            {
+                for (int i = 0; i < count; ++i, sample += decimation)
+                {
+                    //side across, mid up
+                    const auto l = left[sample], r = right[sample];
+                    points[static_cast<size_t>(start + i)] = { (l - r) * MathConstants<float>::sqrt2 * 0.5f,
+                                                               (l + r) * MathConstants<float>::sqrt2 * 0.5f };
+                }
+            };
+
+            writePoints(scope.startIndex1, scope.blockSize1);
+            writePoints(scope.startIndex2, scope.blockSize2);
+        }
+    };
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+
+namespace Dsp
+{
+    using namespace juce;
+
+    /*
+     single writer, single reader triple buffer. the writer fills the back
+     buffer and swaps it with the middle one, the reader swaps the middle one
+     with its front buffer when a new one has been published. neither side
+     ever waits, and the reader always sees a complete snapshot.
+     */
+    template<typename T>
+    class TripleBuffer
+    {
+    public:
+        //writer only, the buffer to fill before publish()
+        T& getWriteBuffer() { return buffers[back]; }
+
+        void publish()
+        {
+            back = middle.exchange(back | newDataBit, std::memory_order_acq_rel) & indexMask;
+        }
+
+        //reader only, copies the latest snapshot, returns false if nothing new was published
+        bool read(T& dest)
+        {
+            if ((middle.load(std::memory_order_relaxed) & newDataBit) == 0)
+                return false;
+
+            front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+            dest = buffers[front];
+            return true;
+        }
+    private:
+        static constexpr int newDataBit = 4;
+        static constexpr int indexMask = 3;
+
+        std::array<T, 3> buffers{};
+        int back = 0, front = 2;
+        std::atomic<int> middle{ 1 };
+    };
+
+    //what the audio thread reports to the editor once per block
+    struct TelemetrySnapshot
+    {
+        static constexpr int numChannels = 2;
+
+        struct Channel
+        {
+            //output of the block, in dB
+            float peak = -100.f;
+            float rms = -100.f;
+
+            //output samples at or over full scale, and runs of 3 or more of them, since the last reset
+            uint32 clipCount = 0;
+            uint32 overCount = 0;
+
+            //peak level the tanh stage takes off the driven signal, in dB
+            float driveReduction = 0.f;
+
+            //how much quieter the output is than the filtered input, in dB
+            float gainReduction = 0.f;
+        };
+
+        std::array<Channel, numChannels> channels;
+
+        //blocks processed since the meters started, and the rate they ran at
+        uint64 blockCount = 0;
+        double sampleRate = 0.0;
+    };
+};
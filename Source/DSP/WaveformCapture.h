@@ -0,0 +1,229 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+
+namespace Dsp
+{
+    using namespace juce;
+
+    /*
+     headless waveform capture for the editor's waveform view.
+
+     the audio thread folds every block into a pyramid of min/max buckets:
+     level 0 buckets cover 8 samples and every level above covers 4 buckets
+     of the one below, so building it costs O(1) per sample. each level is a
+     fixed ring, which bounds memory and still keeps minutes of history at the
+     coarse end.
+
+     there is one writer (the audio thread) and any number of readers. a reader
+     reads the bucket count, copies the buckets and reads the count again,
+     anything the writer may have wrapped over in between is dropped, so no
+     locks are needed on either side.
+     */
+    class WaveformCapture
+    {
+    public:
+        struct MinMax
+        {
+            float min = 0.f, max = 0.f;
+        };
+
+        static constexpr int numChannels = 2;
+        static constexpr int numLevels = 6;
+        static constexpr int samplesPerBucket = 8;
+        static constexpr int bucketsPerParent = 4;
+        static constexpr int bucketsPerLevel = 4096;
+
+        //readers stay this far behind the write position so the ring can't wrap mid read
+        static constexpr int readMargin = 256;
+
+        WaveformCapture()
+        {
+            for (auto& level : levels)
+                for (auto& ring : level.rings)
+                    ring.resize(bucketsPerLevel);
+        }
+
+        //samples covered by one bucket of a level
+        static int64 getBucketSize(int level)
+        {
+            int64 size = samplesPerBucket;
+            for (int i = 0; i < level; ++i)
+                size *= bucketsPerParent;
+            return size;
+        }
+
+        //the longest span the pyramid can draw, in samples
+        static int64 getMaxSpan()
+        {
+            return getBucketSize(numLevels - 1) * (bucketsPerLevel - readMargin);
+        }
+
+        //audio thread only
+        void push(const AudioBuffer<float>& buffer)
+        {
+            const auto numSamples = buffer.getNumSamples();
+            const auto channelsToUse = jmin(numChannels, buffer.getNumChannels());
+
+            int start = 0;
+            while (start < numSamples)
+            {
+                //fill the current level 0 bucket as far as this block allows
+                const auto count = jmin(samplesPerBucket - pending[0].count, numSamples - start);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    //a mono input is mirrored so both lanes show something
+                    auto range = FloatVectorOperations::findMinAndMax(buffer.getReadPointer(jmin(ch, channelsToUse - 1), start), count);
+                    merge(pending[0].values[ch], { range.getStart(), range.getEnd() }, pending[0].count == 0);
+                }
+
+                pending[0].count += count;
+                start += count;
+
+                if (pending[0].count == samplesPerBucket)
+                    completeBucket(0);
+            }
+        }
+
+        //audio thread only, forgets everything captured so far
+        void reset()
+        {
+            for (auto& p : pending)
+                p = {};
+
+            for (auto& level : levels)
+                level.written.store(0, std::memory_order_release);
+        }
+
+        //total number of buckets a level has completed, only ever grows until reset()
+        int64 getNumWritten(int level) const { return levels[level].written.load(std::memory_order_acquire); }
+
+        /*
+         reduces the most recent spanSamples of one channel into numColumns
+         min/max pairs, oldest first. the coarsest level that still gives at
+         least one bucket per column is used, so the cost is O(numColumns)
+         whatever the span. returns the number of columns that hold data,
+         counted from the right, the rest are left empty.
+         */
+        int read(int channel, int64 spanSamples, MinMax* dest, int numColumns) const
+        {
+            jassert(isPositiveAndBelow(channel, numChannels));
+
+            for (int i = 0; i < numColumns; ++i)
+                dest[i] = {};
+
+            if (numColumns <= 0 || spanSamples <= 0)
+                return 0;
+
+            spanSamples = jmin(spanSamples, getMaxSpan());
+
+            //coarsest level whose buckets are still no wider than a column
+            int levelIndex = 0;
+            while (levelIndex + 1 < numLevels && getBucketSize(levelIndex + 1) * numColumns <= spanSamples)
+                ++levelIndex;
+
+            const auto& level = levels[levelIndex];
+            const auto bucketSize = getBucketSize(levelIndex);
+            const auto numBuckets = jmax<int64>(1, spanSamples / bucketSize);
+
+            const auto end = level.written.load(std::memory_order_acquire);
+            if (end <= 0)
+                return 0;
+
+            const auto& ring = level.rings[channel];
+            const auto first = end - numBuckets;
+
+            //the buckets a column covers, at least one when zoomed in past the bucket size
+            auto getColumnRange = [&](int column)
+            {
+                const auto from = first + (numBuckets * column) / numColumns;
+                return Range<int64>(from, jmax(from + 1, first + (numBuckets * (column + 1)) / numColumns));
+            };
+
+            for (int column = 0; column < numColumns; ++column)
+            {
+                const auto range = getColumnRange(column);
+                const auto from = jmax<int64>(range.getStart(), 0);
+                if (from >= range.getEnd())
+                    continue;
+
+                auto value = ring[static_cast<size_t>(from % bucketsPerLevel)];
+                for (auto i = from + 1; i < range.getEnd(); ++i)
+                    merge(value, ring[static_cast<size_t>(i % bucketsPerLevel)], false);
+
+                dest[column] = value;
+            }
+
+            //anything the writer has wrapped over since reading is dropped
+            const auto oldestSafe = jmax<int64>(0, level.written.load(std::memory_order_acquire) - (bucketsPerLevel - readMargin));
+            int filled = 0;
+
+            for (int column = 0; column < numColumns; ++column)
+            {
+                if (getColumnRange(column).getStart() < oldestSafe)
+                    dest[column] = {};
+                else
+                    ++filled;
+            }
+
+            return filled;
+        }
+
+    private:
+        struct Level
+        {
+            std::array<std::vector<MinMax>, numChannels> rings;
+            std::atomic<int64> written{ 0 };
+        };
+
+        //the bucket each level is currently building, audio thread only
+        struct Pending
+        {
+            std::array<MinMax, numChannels> values;
+            int count = 0;
+        };
+
+        std::array<Level, numLevels> levels;
+        std::array<Pending, numLevels> pending;
+
+        static void merge(MinMax& into, MinMax other, bool first)
+        {
+            if (first)
+            {
+                into = other;
+                return;
+            }
+
+            into.min = jmin(into.min, other.min);
+            into.max = jmax(into.max, other.max);
+        }
+
+        void completeBucket(int levelIndex)
+        {
+            auto& level = levels[levelIndex];
+            auto& p = pending[levelIndex];
+            const auto index = level.written.load(std::memory_order_relaxed);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                level.rings[ch][static_cast<size_t>(index % bucketsPerLevel)] = p.values[ch];
+
+            level.written.store(index + 1, std::memory_order_release);
+
+            //fold the finished bucket into the level above
+            if (levelIndex + 1 < numLevels)
+            {
+                auto& parent = pending[levelIndex + 1];
+                for (int ch = 0; ch < numChannels; ++ch)
+                    merge(parent.values[ch], p.values[ch], parent.count == 0);
+
+                if (++parent.count == bucketsPerParent)
+                    completeBucket(levelIndex + 1);
+            }
+
+            p.count = 0;
+        }
+    };
+};
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <limits>
+#include <type_traits>
+
+/*
+ every parameter of the plugin, in one table.
+
+ the layout, the processor's cached handles and the editor's attachments are
+ all built from it, so each ID is written exactly once and code refers to a
+ parameter by its enum. a misspelt parameter is a compile error instead of a
+ null pointer at runtime.
+
+ the table is in the order hosts see the parameters, and the IDs are what
+ saved sessions store. add new ones before NumParameters, never reorder or
+ rename the old ones.
+ */
+namespace Params
+{
+    enum class Type
+    {
+        Float,
+        Choice,
+        Bool
+    };
+
+    enum Id
+    {
+        LowCutFreq,
+        HighCutFreq,
+        LowCutSlope,
+        HighCutSlope,
+        Drive,
+        PostGain,
+        Mix,
+        LowCutBypassed,
+        HighCutBypassed,
+        SpectrumEnabled,
+        HelpButton,
+        AnalyzerResolution,
+        AnalyzerAveraging,
+        AnalyzerHold,
+        AnalyzerOverlay,
+        AnalyzerView,
+        QualityMode,
+        QualityTier,
+        NumParameters
+    };
+
+    struct Info
+    {
+        Id index;
+        const char* id;
+        Type type;
+
+        //floats use the whole range, choices and bools only the default (an index, or 0/1)
+        float start, end, interval, skew;
+        float defaultValue;
+
+        //choice names, separated by '|'
+        const char* choices;
+
+        bool automatable;
+    };
+
+    inline constexpr std::array<Info, NumParameters> table
+    {{
+        //normalisableRange -> (lower frequency, upper frequency, frequency step, skew)
+        { LowCutFreq,         "LowCut Freq",         Type::Float,  10.f,  20000.f, 1.f,   0.25f, 10.f,    "", true },
+        { HighCutFreq,        "HighCut Freq",        Type::Float,  10.f,  20000.f, 1.f,   0.25f, 20000.f, "", true },
+
+        //a 12 dB/Oct filter cascaded up to four times
+        { LowCutSlope,        "LowCut Slope",        Type::Choice, 0.f, 0.f, 0.f, 0.f, 0.f, "12 db/Oct|24 db/Oct|36 db/Oct|48 db/Oct", true },
+        { HighCutSlope,       "HighCut Slope",       Type::Choice, 0.f, 0.f, 0.f, 0.f, 0.f, "12 db/Oct|24 db/Oct|36 db/Oct|48 db/Oct", true },
+
+        //distortion
+        { Drive,              "Drive",               Type::Float,  1.f,   10.f,    0.01f, 1.f,   1.f,     "", true },
+        { PostGain,           "Post Gain",           Type::Float,  -12.f, 0.f,     0.01f, 1.f,   0.f,     "", true },
+        { Mix,                "Mix",                 Type::Float,  0.f,   1.f,     0.01f, 1.f,   1.f,     "", true },
+
+        //toggle boxes
+        { LowCutBypassed,     "LowCut Bypassed",     Type::Bool,   0.f, 0.f, 0.f, 0.f, 0.f, "", true },
+        { HighCutBypassed,    "HighCut Bypassed",    Type::Bool,   0.f, 0.f, 0.f, 0.f, 0.f, "", true },
+        { SpectrumEnabled,    "Spectrum Enabled",    Type::Bool,   0.f, 0.f, 0.f, 0.f, 1.f, "", true },
+
+        //toggle box for help menu
+        { HelpButton,         "Help Button",         Type::Bool,   0.f, 0.f, 0.f, 0.f, 0.f, "", true },
+
+        //FFT size of the spectrum analyser, or the octave band analyser
+        { AnalyzerResolution, "Analyzer Resolution", Type::Choice, 0.f, 0.f, 0.f, 0.f, 1.f, "2048|4096|8192|Multi-Res", true },
+
+        //analyser ballistics: exponential averaging time and peak hold behaviour
+        { AnalyzerAveraging,  "Analyzer Averaging",  Type::Choice, 0.f, 0.f, 0.f, 0.f, 0.f, "Off|Fast|Medium|Slow", true },
+        { AnalyzerHold,       "Analyzer Hold",       Type::Choice, 0.f, 0.f, 0.f, 0.f, 0.f, "Off|Peak Hold|Infinite", true },
+
+        //which two signals the analyser overlays, and traces or a scrolling spectrogram
+        { AnalyzerOverlay,    "Analyzer Overlay",    Type::Choice, 0.f, 0.f, 0.f, 0.f, 0.f, "Left / Right|Pre / Post", true },
+        { AnalyzerView,       "Analyzer View",       Type::Choice, 0.f, 0.f, 0.f, 0.f, 0.f, "Spectrum|Spectrogram", true },
+
+        //Auto lets the processor step its quality down under CPU pressure, the others pin a tier
+        { QualityMode,        "Quality Mode",        Type::Choice, 0.f, 0.f, 0.f, 0.f, 0.f, "Auto|Full|Reduced|Economy|Minimal", true },
+
+        //the tier processBlock is running at, only the processor sets this one
+        { QualityTier,        "Quality Tier",        Type::Choice, 0.f, 0.f, 0.f, 0.f, 0.f, "Full|Reduced|Economy|Minimal", false },
+    }};
+
+    //every entry is at its own index, so table[id] is always that parameter
+    constexpr bool isInOrder()
+    {
+        for (size_t i = 0; i < table.size(); ++i)
+            if (static_cast<size_t>(table[i].index) != i)
+                return false;
+
+        return true;
+    }
+
+    static_assert(isInOrder(), "Params::table has to be in the order of Params::Id");
+
+    constexpr const Info& getInfo(Id id) { return table[static_cast<size_t>(id)]; }
+    inline juce::String getID(Id id) { return getInfo(id).id; }
+
+    //the tier is what the processor reports, not a setting, so sessions don't save or restore it
+    constexpr bool isSaved(Id id) { return id != QualityTier; }
+
+    //what a parameter reads as on the audio thread: floats, choice indices and bools
+    template<Id id>
+    using ValueType = std::conditional_t<getInfo(id).type == Type::Float, float,
+                      std::conditional_t<getInfo(id).type == Type::Bool, bool, int>>;
+
+    inline juce::AudioProcessorValueTreeState::ParameterLayout createLayout()
+    {
+        juce::AudioProcessorValueTreeState::ParameterLayout layout;
+
+        for (const auto& info : table)
+        {
+            switch (info.type)
+            {
+                case Type::Float:
+                    layout.add(std::make_unique<juce::AudioParameterFloat>(info.id, info.id,
+                        juce::NormalisableRange<float>(info.start, info.end, info.interval, info.skew), info.defaultValue,
+                        juce::AudioParameterFloatAttributes().withAutomatable(info.automatable)));
+                    break;
+                case Type::Choice:
+                    layout.add(std::make_unique<juce::AudioParameterChoice>(info.id, info.id,
+                        juce::StringArray::fromTokens(info.choices, "|", ""), static_cast<int>(info.defaultValue),
+                        juce::AudioParameterChoiceAttributes().withAutomatable(info.automatable)));
+                    break;
+                case Type::Bool:
+                    layout.add(std::make_unique<juce::AudioParameterBool>(info.id, info.id, info.defaultValue > 0.5f,
+                        juce::AudioParameterBoolAttributes().withAutomatable(info.automatable)));
+                    break;
+            }
+        }
+
+        return layout;
+    }
+
+    //every parameter and its raw value, looked up once so nothing after construction searches by ID
+    class Handles
+    {
+    public:
+        explicit Handles(juce::AudioProcessorValueTreeState& apvts)
+        {
+            for (const auto& info : table)
+            {
+                const auto index = static_cast<size_t>(info.index);
+                parameters[index] = apvts.getParameter(info.id);
+                rawValues[index] = apvts.getRawParameterValue(info.id);
+
+                jassert(parameters[index] != nullptr && rawValues[index] != nullptr);
+            }
+        }
+
+        juce::RangedAudioParameter& getParameter(Id id) const { return *parameters[static_cast<size_t>(id)]; }
+        std::atomic<float>& getRawValue(Id id) const { return *rawValues[static_cast<size_t>(id)]; }
+    private:
+        std::array<juce::RangedAudioParameter*, NumParameters> parameters{};
+        std::array<std::atomic<float>*, NumParameters> rawValues{};
+    };
+
+    /*
+     the audio thread's copy of every parameter, taken once at the start of a
+     block. each parameter has a version that goes up whenever its value
+     changes, so work that depends on a few parameters can be skipped while
+     none of them move.
+     */
+    class Snapshot
+    {
+    public:
+        //the first update() counts as a change for every parameter
+        Snapshot() { values.fill(std::numeric_limits<float>::quiet_NaN()); }
+
+        //audio thread, once at the start of every block. the loads are sequentially consistent so
+        //the processor can tell whether they might have caught a state restore part way through
+        void update(const Handles& handles)
+        {
+            for (size_t i = 0; i < values.size(); ++i)
+                set(static_cast<Id>(i), handles.getRawValue(static_cast<Id>(i)).load());
+        }
+
+        //audio thread, overrides a parameter for this block, e.g. with a CC it hasn't caught up with yet
+        void set(Id id, float value)
+        {
+            auto& current = values[static_cast<size_t>(id)];
+            if (current != value)
+            {
+                current = value;
+                ++versions[static_cast<size_t>(id)];
+            }
+        }
+
+        template<Id id>
+        ValueType<id> get() const
+        {
+            const auto value = values[static_cast<size_t>(id)];
+
+            if constexpr (getInfo(id).type == Type::Float)
+                return value;
+            else if constexpr (getInfo(id).type == Type::Bool)
+                return value > 0.5f;
+            else
+                return juce::roundToInt(value);
+        }
+
+        float getRawValue(Id id) const { return values[static_cast<size_t>(id)]; }
+
+        juce::uint32 getVersion(Id id) const { return versions[static_cast<size_t>(id)]; }
+
+        //changes whenever any of the parameters does
+        juce::uint32 getVersion(std::initializer_list<Id> ids) const
+        {
+            juce::uint32 sum = 0;
+            for (auto id : ids)
+                sum += getVersion(id);
+
+            return sum;
+        }
+    private:
+        std::array<float, NumParameters> values;
+        std::array<juce::uint32, NumParameters> versions{};
+    };
+};
@@ -460,8 +460,7 @@ juce::Rectangle<int> VerticalLinearSlider::getSliderBounds() const
 //response curve
 ResponseCurveComponent::ResponseCurveComponent(CourseworkPluginAudioProcessor& p) : 
     audioProcessor(p),
-leftPathProducer(audioProcessor.leftChannelFifo),
-rightPathProducer(audioProcessor.rightChannelFifo)
+analyzerPathProducer(audioProcessor.leftChannelFifo, audioProcessor.rightChannelFifo)
 {
     const auto& params = audioProcessor.getParameters();
     for (auto param : params)
@@ -469,9 +468,22 @@ rightPathProducer(audioProcessor.rightChannelFifo)
         param->addListener(this);
     }
 
-    //update curve
+    for (auto id : { Params::LowCutFreq, Params::HighCutFreq, Params::LowCutSlope, Params::HighCutSlope, Params::LowCutBypassed, Params::HighCutBypassed })
+    {
+        filterParameterIndices.add(audioProcessor.parameters.getParameter(id).getParameterIndex());
+    }
+
+    analyzerResolution = &audioProcessor.parameters.getRawValue(Params::AnalyzerResolution);
+    analyzerAveraging = &audioProcessor.parameters.getRawValue(Params::AnalyzerAveraging);
+    analyzerHold = &audioProcessor.parameters.getRawValue(Params::AnalyzerHold);
+    analyzerOverlay = &audioProcessor.parameters.getRawValue(Params::AnalyzerOverlay);
+    analyzerView = &audioProcessor.parameters.getRawValue(Params::AnalyzerView);
+
+    //update curve, the editor's frame clock takes it from here
     updateChain();
-    startTimerHz(60);
+
+    //the path producer drained the fifos when it was built, so it's safe to start capturing
+    analyzerSubscription = audioProcessor.captureRegistry.subscribe(CaptureStream::Analyzer);
 }
 
 ResponseCurveComponent::~ResponseCurveComponent()
@@ -485,92 +497,411 @@ ResponseCurveComponent::~ResponseCurveComponent()
 
 void ResponseCurveComponent::parameterValueChanged(int parameterIndex, float newValue)
 {
-    parametersChanged.set(true);
+    //drive, mix and the analyser settings don't change the curve
+    if (filterParameterIndices.contains(parameterIndex))
+        parametersChanged.set(true);
 }
 
 //produces path for FFT
-void PathProducer::process(juce::Rectangle<float> fftBounds, double sampleRate)
+bool PathProducer::process(juce::Rectangle<float> fftBounds, double sampleRate)
 {
-    juce::AudioBuffer<float> tempIncomingBuffer;
+    auto& first = channels[0];
+    auto& second = channels[1];
 
-    while (leftChannelFifo->getNumCompleteBuffersAvailable() > 0)
+    //both fifos are filled from the same processBlock, so they're pulled in pairs
+    while (first.fifo->getNumCompleteBuffersAvailable() > 0 && second.fifo->getNumCompleteBuffersAvailable() > 0)
     {
-        if (leftChannelFifo->getAudioBuffer(tempIncomingBuffer))
+        if (!first.fifo->getAudioBuffer(first.incoming) || !second.fifo->getAudioBuffer(second.incoming))
+            break;
+
+        for (auto& channel : channels)
         {
-            auto size = tempIncomingBuffer.getNumSamples();
+            auto& history = channel.history;
+            auto size = juce::jmin(channel.incoming.getNumSamples(), history.getNumSamples());
 
+            //the history is kept up to date in both modes so switching back is instant
             juce::FloatVectorOperations::copy(
-                monoBuffer.getWritePointer(0, 0),
-                monoBuffer.getReadPointer(0, size),
-                monoBuffer.getNumSamples() - size);
+                history.getWritePointer(0, 0),
+                history.getReadPointer(0, size),
+                history.getNumSamples() - size);
 
             juce::FloatVectorOperations::copy(
-                monoBuffer.getWritePointer(0, monoBuffer.getNumSamples() - size),
-                tempIncomingBuffer.getReadPointer(0, 0),
+                history.getWritePointer(0, history.getNumSamples() - size),
+                channel.incoming.getReadPointer(0, channel.incoming.getNumSamples() - size),
                 size);
 
-            leftChannelFFTDataGenerator.produceFFTDataForRendering(monoBuffer, -48.f);
+            hopSize = size;
+        }
+
+        if (multiResolution)
+        {
+            multiResolutionAnalyzer.pushSamples(first.incoming.getReadPointer(0),
+                second.incoming.getReadPointer(0),
+                juce::jmin(first.incoming.getNumSamples(), second.incoming.getNumSamples()),
+                negativeInfinity);
+        }
+        else
+        {
+            fftDataGenerator.produceFFTDataForRendering(first.history, second.history, negativeInfinity);
+        }
+    }
+
+    auto hasNewPaths = multiResolution
+        ? produceMultiResolutionPaths(fftBounds, sampleRate)
+        : produceSingleResolutionPaths(fftBounds, sampleRate);
+
+    /*
+    * while there are paths can be pulled
+    *   pull as many as we can
+    *       display most recent path
+    */
+
+    for (auto& channel : channels)
+    {
+        while (channel.pathGenerator.getNumPathsAvailable())
+        {
+            channel.pathGenerator.getPath(channel.path);
+        }
+
+        while (channel.peakPathGenerator.getNumPathsAvailable())
+        {
+            channel.peakPathGenerator.getPath(channel.peakPath);
         }
     }
 
-    const auto fftSize = leftChannelFFTDataGenerator.getFFTSize();
+    return hasNewPaths;
+}
+
+bool PathProducer::produceSingleResolutionPaths(juce::Rectangle<float> fftBounds, double sampleRate)
+{
+    const auto fftSize = fftDataGenerator.getFFTSize();
+
+    const auto numBins = fftSize / 2;
 
     const auto binWidth = sampleRate / (double)fftSize;
 
+    const auto frameSeconds = sampleRate > 0.0 ? float(hopSize / sampleRate) : 0.f;
+
     /*
     * if there are FFT data buffers to pull
     *   if we can pull a buffer
-    *       generate a path
+    *       fold each channel into its averaged and peak traces
+    * only the latest state needs a path
     */
-    while (leftChannelFFTDataGenerator.getNumAvailableFFTDataBlocks() > 0)
+    bool hasNewFrame = false;
+
+    while (fftDataGenerator.getNumAvailableFFTDataBlocks() > 0)
+    {
+        if (fftDataGenerator.getFFTData(fftData))
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                channels[ch].ballistics.process(fftData.data() + ch * numBins, numBins, frameSeconds);
+
+            //the spectrogram gets a column for every frame, not just the latest one
+            if (spectrogramEnabled)
+            {
+                SpectrogramSources sources;
+                sources[0].numBins = numBins;
+                sources[0].binWidth = float(binWidth);
+
+                SpectrogramData data;
+                for (int ch = 0; ch < numChannels; ++ch)
+                    data[ch][0] = channels[ch].ballistics.getAveraged().data();
+
+                addSpectrogramColumn(sources, 1, data);
+            }
+
+            hasNewFrame = true;
+        }
+    }
+
+    if (hasNewFrame)
     {
-        std::vector<float> fftData;
-        if (leftChannelFFTDataGenerator.getFFTData(fftData))
+        for (auto& channel : channels)
         {
-            pathProducer.generatePath(fftData, fftBounds, fftSize, binWidth, -48.f);
+            channel.pathGenerator.generatePath(channel.ballistics.getAveraged(), fftBounds, fftSize, binWidth, negativeInfinity);
+
+            if (isShowingPeak())
+                channel.peakPathGenerator.generatePath(channel.ballistics.getPeak(), fftBounds, fftSize, binWidth, negativeInfinity);
         }
     }
 
-    /*
-    * while there are paths can be pulled
-    *   pull as many as we can
-    *       display most recent path
-    */
+    return hasNewFrame;
+}
+
+bool PathProducer::produceMultiResolutionPaths(juce::Rectangle<float> fftBounds, double sampleRate)
+{
+    using MRA = MultiResolutionAnalyzer;
+
+    bool hasNewFrame = false;
+
+    //frames of the top band, which hops fastest, since the last call
+    int topBandFrames = 0;
+
+    //each band only updates its traces when it has analysed something new
+    for (int stage = 0; stage < MRA::numStages; ++stage)
+    {
+        if (auto frames = multiResolutionAnalyzer.takeNewFrames(stage); frames > 0)
+        {
+            if (stage == 0)
+                topBandFrames = frames;
+
+            const auto stageRate = MRA::getStageSampleRate(stage, sampleRate);
+            const auto frameSeconds = stageRate > 0.0 ? float(frames * MRA::hopSize / stageRate) : 0.f;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                channels[ch].multiResolutionBallistics[stage].process(multiResolutionAnalyzer.getSpectrum(stage, ch).data(),
+                    MRA::numBins,
+                    frameSeconds);
+            }
+
+            hasNewFrame = true;
+        }
+    }
+
+    if (!hasNewFrame)
+        return false;
+
+    std::array<SpectrumSource, MRA::numStages> sources;
+
+    for (int stage = 0; stage < MRA::numStages; ++stage)
+    {
+        sources[stage].numBins = MRA::numBins;
+        sources[stage].binWidth = float(MRA::getStageBinWidth(stage, sampleRate));
+        sources[stage].minFrequency = float(MRA::getStageMinFrequency(stage, sampleRate));
+    }
 
-    while (pathProducer.getNumPathsAvailable())
+    //one column per top band frame, so time scrolls at the hop rate like the single resolution
+    //view, whatever the display rate. only the latest spectra are kept, so a call that covers
+    //several frames repeats them
+    if (spectrogramEnabled)
     {
-        pathProducer.getPath(leftChannelFFTPath);
+        SpectrogramData data;
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int stage = 0; stage < MRA::numStages; ++stage)
+                data[ch][stage] = channels[ch].multiResolutionBallistics[stage].getAveraged().data();
+
+        for (int frame = 0; frame < topBandFrames; ++frame)
+        {
+            auto spectrogramSources = sources;
+            addSpectrogramColumn(spectrogramSources, MRA::numStages, data);
+        }
+    }
+
+    for (auto& channel : channels)
+    {
+        for (int stage = 0; stage < MRA::numStages; ++stage)
+            sources[stage].data = channel.multiResolutionBallistics[stage].getAveraged().data();
+
+        channel.pathGenerator.generatePath(sources.data(), MRA::numStages, fftBounds, negativeInfinity);
+
+        if (isShowingPeak())
+        {
+            for (int stage = 0; stage < MRA::numStages; ++stage)
+                sources[stage].data = channel.multiResolutionBallistics[stage].getPeak().data();
+
+            channel.peakPathGenerator.generatePath(sources.data(), MRA::numStages, fftBounds, negativeInfinity);
+        }
+    }
+
+    return true;
+}
+
+void PathProducer::setSpectrogram(bool enabled, juce::Rectangle<int> area, int channel)
+{
+    jassert(channel >= -1 && channel < numChannels);
+
+    //a different channel is a different picture, so the history starts again
+    if (enabled != spectrogramEnabled || channel != spectrogramChannel)
+        spectrogram.clear();
+
+    spectrogramEnabled = enabled;
+    spectrogramChannel = channel;
+
+    if (enabled)
+        spectrogram.prepare(area.getWidth(), area.getHeight());
+}
+
+void PathProducer::addSpectrogramColumn(SpectrogramSources& sources, int numSources, const SpectrogramData& data)
+{
+    for (int i = 0; i < numSources; ++i)
+    {
+        jassert(sources[i].numBins <= spectrogramScratchBins);
+
+        if (spectrogramChannel >= 0)
+        {
+            sources[i].data = data[spectrogramChannel][i];
+            continue;
+        }
+
+        //the louder of the two channels in every bin
+        auto* combined = spectrogramScratch.data() + i * spectrogramScratchBins;
+        juce::FloatVectorOperations::max(combined, data[0][i], data[1][i], sources[i].numBins);
+        sources[i].data = combined;
+    }
+
+    spectrogram.addColumn(sources.data(), numSources, negativeInfinity);
+}
+
+void PathProducer::resetAnalysis()
+{
+    multiResolutionAnalyzer.reset(negativeInfinity);
+    spectrogram.clear();
+
+    for (auto& channel : channels)
+    {
+        channel.ballistics.reset(negativeInfinity);
+
+        for (auto& stageBallistics : channel.multiResolutionBallistics)
+            stageBallistics.reset(negativeInfinity);
     }
 }
 
-void ResponseCurveComponent::timerCallback()
+void PathProducer::setSources(SampleFifo& first, SampleFifo& second)
 {
+    if (channels[0].fifo == &first && channels[1].fifo == &second)
+        return;
+
+    channels[0].fifo = &first;
+    channels[1].fifo = &second;
+
+    restart();
+}
+
+void PathProducer::restart()
+{
+    //whatever is queued up may be old, or from the other channel pair
+    for (auto& channel : channels)
+    {
+        while (channel.fifo->getNumCompleteBuffersAvailable() > 0)
+            channel.fifo->getAudioBuffer(channel.incoming);
+
+        channel.history.clear();
+    }
+
+    resetAnalysis();
+}
+
+void PathProducer::setFFTOrder(FFTOrder newOrder)
+{
+    if (fftDataGenerator.getOrder() == newOrder)
+        return;
+
+    fftDataGenerator.changeOrder(newOrder);
+
+    //old traces were measured with a different bin spacing
+    for (auto& channel : channels)
+        channel.ballistics.reset(negativeInfinity);
+}
+
+void PathProducer::setMultiResolution(bool shouldUseMultiResolution)
+{
+    if (multiResolution == shouldUseMultiResolution)
+        return;
+
+    multiResolution = shouldUseMultiResolution;
+
+    //the bands fill from silence again, and the single FFT only has to catch up
+    //with whatever it missed while the bands were running
+    resetAnalysis();
+}
+
+void PathProducer::setBallistics(float averagingTime, SpectrumBallistics::HoldMode holdMode)
+{
+    const auto holdModeChanged = holdMode != channels[0].ballistics.getHoldMode();
+
+    for (auto& channel : channels)
+    {
+        channel.ballistics.setAveragingTime(averagingTime);
+        for (auto& stageBallistics : channel.multiResolutionBallistics)
+            stageBallistics.setAveragingTime(averagingTime);
+
+        if (holdModeChanged)
+        {
+            //start the new peak trace from the current spectrum
+            channel.ballistics.setHoldMode(holdMode);
+            channel.ballistics.reset(negativeInfinity);
+
+            for (auto& stageBallistics : channel.multiResolutionBallistics)
+            {
+                stageBallistics.setHoldMode(holdMode);
+                stageBallistics.reset(negativeInfinity);
+            }
+
+            channel.peakPath.clear();
+        }
+    }
+}
+
+bool ResponseCurveComponent::frameTick()
+{
+    bool needsRepaint = false;
+
+    const auto qualityTier = audioProcessor.getQualityTier();
+    if (qualityTier != shownQualityTier)
+    {
+        shownQualityTier = qualityTier;
+        needsRepaint = true;
+    }
+
     if (shouldShowFFTAnalysis)
     {
+        //pick up the analyser resolution, this only switches between prebuilt analysers
+        auto resolution = static_cast<int>(analyzerResolution->load());
+        auto multiResolution = resolution == 3;
+        auto order = static_cast<FFTOrder>(FFTOrder::order2048 + juce::jmin(resolution, 2));
+
+        analyzerPathProducer.setMultiResolution(multiResolution);
+        analyzerPathProducer.setFFTOrder(order);
+
+        //averaging times for Off, Fast, Medium and Slow
+        static constexpr float averagingTimes[] = { 0.f, 0.1f, 0.3f, 1.f };
+        auto averagingTime = averagingTimes[juce::jlimit(0, 3, static_cast<int>(analyzerAveraging->load()))];
+        auto holdMode = static_cast<SpectrumBallistics::HoldMode>(static_cast<int>(analyzerHold->load()));
+        analyzerPathProducer.setBallistics(averagingTime, holdMode);
+
+        //either left against right, or the signal before the distortion against after it
+        showingPrePost = analyzerOverlay->load() > 0.5f;
+        if (showingPrePost)
+            analyzerPathProducer.setSources(audioProcessor.preChannelFifo, audioProcessor.leftChannelFifo);
+        else
+            analyzerPathProducer.setSources(audioProcessor.leftChannelFifo, audioProcessor.rightChannelFifo);
+
         //get values
         auto fftBounds = getAnalysisArea().toFloat();
         auto sampleRate = audioProcessor.getSampleRate();
 
-        //produce path for eachh stereo channel
-        leftPathProducer.process(fftBounds, sampleRate);
-        rightPathProducer.process(fftBounds, sampleRate);
+        //the spectrogram follows the post signal in pre/post mode, otherwise the louder channel
+        showingSpectrogram = analyzerView->load() > 0.5f;
+        analyzerPathProducer.setSpectrogram(showingSpectrogram, getAnalysisArea(), showingPrePost ? 1 : -1);
+
+        //produce paths for both channels, only the analysis area needs redrawing. from Reduced on
+        //there's nothing new to analyse, so this mustn't drop the tier change's repaint
+        needsRepaint = analyzerPathProducer.process(fftBounds, sampleRate) || needsRepaint;
     }
     
-    //if parameters change
+    //if parameters or the sample rate change
     //  update the curve
+    if (audioProcessor.getSampleRate() != responseSampleRate)
+        parametersChanged.set(true);
+
     if (parametersChanged.compareAndSetBool(false, true))
     {
         //update the monochain
         updateChain();
+        needsRepaint = true;
     }
 
-    //constantly repaint
-    repaint();
+    if (needsRepaint)
+        repaint(getRenderArea());
+
+    return needsRepaint;
 }
 
 void ResponseCurveComponent::updateChain()
 {
-    auto chainSettings = getChainSettings(audioProcessor.apvts);
+    auto chainSettings = getChainSettings(audioProcessor.parameters);
 
     //update the filters based on parameters
     monoChain.setBypassed<ChainPositions::LowCut>(chainSettings.lowCutBypassed);
@@ -581,70 +912,59 @@ void ResponseCurveComponent::updateChain()
 
     updateFilter(monoChain.get<ChainPositions::LowCut>(), lowCutCoefficients, chainSettings.lowCutSlope);
     updateFilter(monoChain.get<ChainPositions::HighCut>(), highCutCoefficients, chainSettings.highCutSlope);
+
+    updateResponseCurve();
 }
 
-void ResponseCurveComponent::paint(juce::Graphics& g)
+void ResponseCurveComponent::updateResponseCurve()
 {
     using namespace juce;
 
-    //g.fillAll(Colours::black);
-
-    g.drawImage(background, getLocalBounds().toFloat());
-
-    //making the response curve that shows what the filters are doing
-    auto bounds = getAnalysisArea();
-
-    //setting bounds
-    auto spectrumArea = bounds;
+    auto spectrumArea = getAnalysisArea();
     auto spectrumW = spectrumArea.getWidth();
-    auto waveformArea = bounds;
-    auto waveformW = waveformArea.getWidth();
-
-    //getting the chains to read off
-    auto& lowcut = monoChain.get<ChainPositions::LowCut>();
-    auto& highcut = monoChain.get<ChainPositions::HighCut>();
-
     auto sampleRate = audioProcessor.getSampleRate();
 
-    std::vector<double> mags;
+    responseCurve.clear();
+    responseSampleRate = sampleRate;
 
-    mags.resize(spectrumW);
+    if (spectrumW <= 0 || sampleRate <= 0.0)
+    {
+        curveLayer = Image();
+        return;
+    }
 
-    //each pixel along the width of the spectrum area
-    for (int i = 0; i < spectrumW; ++i)
+    //the cos/sin basis only depends on the pixel frequencies
+    if (responseEvaluator.getNumPoints() != spectrumW || responseEvaluator.getSampleRate() != sampleRate)
     {
-        double mag = 1.f;
-        auto freq = mapToLog10(double(i) / double(spectrumW), 10.0, 20000.0);
+        std::vector<double> frequencies((size_t)spectrumW);
+        for (int i = 0; i < spectrumW; ++i)
+            frequencies[i] = mapToLog10(double(i) / double(spectrumW), 10.0, 20000.0);
 
-        //change gain of frquqncy at that point depending on if the filters are on
-        if (!monoChain.isBypassed<ChainPositions::LowCut>())
-        {
-            if (!lowcut.isBypassed<0>())
-                mag *= lowcut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if (!lowcut.isBypassed<1>())
-                mag *= lowcut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if (!lowcut.isBypassed<2>())
-                mag *= lowcut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if (!lowcut.isBypassed<3>())
-                mag *= lowcut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        }
-        if (!monoChain.isBypassed<ChainPositions::HighCut>())
+        responseEvaluator.prepare(frequencies, sampleRate);
+    }
+
+    responseEvaluator.reset();
+
+    //fold in every active section of both cut filters
+    auto addCutFilter = [this](auto& cut)
+    {
+        auto addStage = [this](auto& filter)
         {
-            if (!highcut.isBypassed<0>())
-                mag *= highcut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if (!highcut.isBypassed<1>())
-                mag *= highcut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if (!highcut.isBypassed<2>())
-                mag *= highcut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            if (!highcut.isBypassed<3>())
-                mag *= highcut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        }
+            responseEvaluator.addSection(filter.coefficients->getRawCoefficients(), filter.coefficients->coefficients.size());
+        };
 
-        mags[i] = Decibels::gainToDecibels(mag);
-    }
+        if (!cut.template isBypassed<0>()) addStage(cut.template get<0>());
+        if (!cut.template isBypassed<1>()) addStage(cut.template get<1>());
+        if (!cut.template isBypassed<2>()) addStage(cut.template get<2>());
+        if (!cut.template isBypassed<3>()) addStage(cut.template get<3>());
+    };
 
-    //set the curve as a path
-    Path responseCurve;
+    if (!monoChain.isBypassed<ChainPositions::LowCut>())
+        addCutFilter(monoChain.get<ChainPositions::LowCut>());
+    if (!monoChain.isBypassed<ChainPositions::HighCut>())
+        addCutFilter(monoChain.get<ChainPositions::HighCut>());
+
+    responseEvaluator.getDecibels(responseMagnitudes);
 
     //map the gain of frequency to height of path
     const double outputMin = spectrumArea.getBottom();
@@ -654,61 +974,150 @@ void ResponseCurveComponent::paint(juce::Graphics& g)
         return jmap(input, -24.0, 24.0, outputMin, outputMax);
     };
 
-    responseCurve.startNewSubPath(spectrumArea.getX(), map(mags.front()));
+    responseCurve.preallocateSpace(3 * spectrumW);
+    responseCurve.startNewSubPath(spectrumArea.getX(), map(responseMagnitudes.front()));
 
-    for (size_t i = 1; i < mags.size(); ++i)
+    for (size_t i = 1; i < responseMagnitudes.size(); ++i)
     {
-        responseCurve.lineTo(spectrumArea.getX() + i, map(mags[i]));
-    };
+        responseCurve.lineTo(spectrumArea.getX() + i, map(responseMagnitudes[i]));
+    }
+
+    //the curve layer gets redrawn on the next paint
+    curveLayer = Image();
+    repaint(getRenderArea());
+}
+
+void ResponseCurveComponent::paint(juce::Graphics& g)
+{
+    using namespace juce;
+
+    Gui::ScopedPaintTimer paintTimer(*this);
+
+    //g.fillAll(Colours::black);
+
+    //the static layers are rendered at the physical resolution, so they're
+    //rebuilt when the window moves to a display with a different scale
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (background.isNull() || scale != layerScale)
+    {
+        background = renderScaledLayer(getWidth(), getHeight(), scale, [this](Graphics& lg) { drawBackgroundLayer(lg); });
+        curveLayer = Image();
+        layerScale = scale;
+    }
+
+    if (curveLayer.isNull())
+        curveLayer = renderScaledLayer(getWidth(), getHeight(), scale, [this](Graphics& lg) { drawCurveLayer(lg); });
+
+    g.drawImage(background, getLocalBounds().toFloat());
 
     if (shouldShowFFTAnalysis)
+        drawSpectrum(g);
+
+    g.drawImage(curveLayer, getLocalBounds().toFloat());
+
+    if (shownQualityTier != Dsp::QualityTier::Full)
+        drawQualityTier(g);
+
+    if (showHelp)
+        drawHelp(g);
+}
+
+void ResponseCurveComponent::drawQualityTier(juce::Graphics& g)
+{
+    using namespace juce;
+
+    //from Reduced on the analyser isn't fed, so say why it stopped
+    auto area = getAnalysisArea().reduced(6).removeFromTop(14);
+    g.setColour(Colours::orange.withAlpha(0.8f));
+    g.setFont(11.f);
+    g.drawFittedText("Quality: " + String(Dsp::getQualityTierName(shownQualityTier)) + " (CPU)", area, Justification::topRight, 1);
+}
+
+void ResponseCurveComponent::drawSpectrum(juce::Graphics& g)
+{
+    using namespace juce;
+
+    auto spectrumArea = getAnalysisArea();
+
+    //the spectrogram replaces the traces, it's only blitted
+    if (showingSpectrogram)
+    {
+        analyzerPathProducer.getSpectrogram().draw(g, spectrumArea);
+        return;
+    }
+
+    auto translation = AffineTransform().translation(spectrumArea.getX(), spectrumArea.getY());
+
+    //in pre/post mode the first path is the signal before the distortion
+    auto firstColour = showingPrePost ? Colours::lightgrey.withAlpha(0.7f) : Colours::slateblue;
+
+    //peak traces sit dimmer behind the live spectrum
+    if (analyzerPathProducer.isShowingPeak())
     {
-        //generate and paint left channel FFT path
-        auto leftChannelFFTPath = leftPathProducer.getPath();
-        leftChannelFFTPath.applyTransform(AffineTransform().translation(spectrumArea.getX(), spectrumArea.getY()));
+        for (int ch = 0; ch < PathProducer::numChannels; ++ch)
+        {
+            auto peakPath = analyzerPathProducer.getPeakPath(ch);
+            peakPath.applyTransform(translation);
 
-        g.setColour(Colours::slateblue);
-        g.strokePath(leftChannelFFTPath, PathStrokeType(1.f));
+            g.setColour((ch == 0 ? firstColour : Colours::slateblue).withMultipliedAlpha(0.5f));
+            g.strokePath(peakPath, PathStrokeType(1.f));
+        }
+    }
 
-        //generate and paint right channel FFT path
-        auto rightChannelFFTPath = rightPathProducer.getPath();
-        rightChannelFFTPath.applyTransform(AffineTransform().translation(spectrumArea.getX(), spectrumArea.getY()));
+    //generate and paint the FFT path of each channel
+    for (int ch = 0; ch < PathProducer::numChannels; ++ch)
+    {
+        auto channelFFTPath = analyzerPathProducer.getPath(ch);
+        channelFFTPath.applyTransform(translation);
 
-        //g.setColour(Colours::red);
-        g.strokePath(rightChannelFFTPath, PathStrokeType(1.f));
+        g.setColour(ch == 0 ? firstColour : Colours::slateblue);
+        g.strokePath(channelFFTPath, PathStrokeType(1.f));
     }
+}
+
+void ResponseCurveComponent::drawCurveLayer(juce::Graphics& g)
+{
+    using namespace juce;
 
     //draws a box for the area
     g.setColour(Colours::lavender);
     g.drawRoundedRectangle(getRenderArea().toFloat(), 4.f, 1.f);
 
-    //draws the curve
+    //draws the curve, see updateResponseCurve()
     g.setColour(Colours::white);
     g.strokePath(responseCurve, PathStrokeType(2.f));
+}
 
-    if (showHelp)
-    {
-        //help
-        g.fillRoundedRectangle(getLocalBounds().getX() + 40, getLocalBounds().getY() + 5, getLocalBounds().getWidth() - 80, getLocalBounds().getHeight() - 5, 5.f);
-        g.setColour(Colours::black);
-        g.setFont(12);
-        g.drawMultiLineText("Help Menu",
-            getLocalBounds().getX() + 40, 20/*getLocalBounds().getY()*/, getLocalBounds().getWidth() - 80, Justification::centred, 0.0f);
-        g.drawMultiLineText("Low/ High Cut: The knob is the frequency knob, it changes where the sound of the filter. The sliders at the bottom determines how strong and how steep the filters are. There is a power button above each knob to turn the filters off. ",
-            getLocalBounds().getX() + 40, 35/*getLocalBounds().getY()*/, getLocalBounds().getWidth() - 80, Justification::centred, 0.0f);
-        g.drawMultiLineText("Distortion: The Drive knob is used to amplify the audio. The more you amplify, the more the audio clips. You can mix in the original sound back with the Mix slider. The Post Gain knob is used to decrease the volume after distortion. ",
-            getLocalBounds().getX() + 40, 80/*getLocalBounds().getY()*/, getLocalBounds().getWidth() - 80, Justification::centred, 0.0f);
-        g.drawMultiLineText("Spectrum Analyser: You can disable the analyser by pressing the icon in the top left to minimise latency. ",
-            getLocalBounds().getX() + 40, 125/*getLocalBounds().getY()*/, getLocalBounds().getWidth() - 80, Justification::centred, 0.0f);
-    }
+void ResponseCurveComponent::drawHelp(juce::Graphics& g)
+{
+    using namespace juce;
+
+    //help
+    g.setColour(Colours::white);
+    g.fillRoundedRectangle(getLocalBounds().getX() + 40, getLocalBounds().getY() + 5, getLocalBounds().getWidth() - 80, getLocalBounds().getHeight() - 5, 5.f);
+    g.setColour(Colours::black);
+    g.setFont(12);
+    g.drawMultiLineText("Help Menu",
+        getLocalBounds().getX() + 40, 20/*getLocalBounds().getY()*/, getLocalBounds().getWidth() - 80, Justification::centred, 0.0f);
+    g.drawMultiLineText("Low/ High Cut: The knob is the frequency knob, it changes where the sound of the filter. The sliders at the bottom determines how strong and how steep the filters are. There is a power button above each knob to turn the filters off. ",
+        getLocalBounds().getX() + 40, 35/*getLocalBounds().getY()*/, getLocalBounds().getWidth() - 80, Justification::centred, 0.0f);
+    g.drawMultiLineText("Distortion: The Drive knob is used to amplify the audio. The more you amplify, the more the audio clips. You can mix in the original sound back with the Mix slider. The Post Gain knob is used to decrease the volume after distortion. ",
+        getLocalBounds().getX() + 40, 80/*getLocalBounds().getY()*/, getLocalBounds().getWidth() - 80, Justification::centred, 0.0f);
+    g.drawMultiLineText("Spectrum Analyser: You can disable the analyser by pressing the icon in the top left to minimise latency. ",
+        getLocalBounds().getX() + 40, 125/*getLocalBounds().getY()*/, getLocalBounds().getWidth() - 80, Justification::centred, 0.0f);
 }
 
 void ResponseCurveComponent::resized()
 {
-    using namespace juce;
-    background = Image(Image::PixelFormat::ARGB, getWidth(), getHeight(), true);  
+    //the layers are redrawn at the new size on the next paint
+    background = juce::Image();
 
-    Graphics g(background);
+    updateResponseCurve();
+}
+
+void ResponseCurveComponent::drawBackgroundLayer(juce::Graphics& g)
+{
+    using namespace juce;
 
     g.setColour(juce::Colours::black);
     //g.setOpacity(0.5f);
@@ -855,35 +1264,35 @@ juce::Rectangle<int> ResponseCurveComponent::getAnalysisArea()
 CourseworkPluginAudioProcessorEditor::CourseworkPluginAudioProcessorEditor (CourseworkPluginAudioProcessor& p)
     : AudioProcessorEditor (&p), audioProcessor (p),
 
-    highCutFreqSlider   (*audioProcessor.apvts.getParameter("HighCut Freq"), "Hz"),
-    lowCutFreqSlider    (*audioProcessor.apvts.getParameter("LowCut Freq"), "Hz"),
-    driveSlider         (*audioProcessor.apvts.getParameter("Drive"), ""),
-    postGainSlider      (*audioProcessor.apvts.getParameter("Post Gain"), "dB"),
-    distortionMix       (*audioProcessor.apvts.getParameter("Mix"), ""),
-    lowCutSlopeSelect   (*audioProcessor.apvts.getParameter("LowCut Slope"), "dB/Oct"),
-    highCutSlopeSelect  (*audioProcessor.apvts.getParameter("HighCut Slope"), "dB/Oct"),
+    highCutFreqSlider   (audioProcessor.parameters.getParameter(Params::HighCutFreq), "Hz"),
+    lowCutFreqSlider    (audioProcessor.parameters.getParameter(Params::LowCutFreq), "Hz"),
+    driveSlider         (audioProcessor.parameters.getParameter(Params::Drive), ""),
+    postGainSlider      (audioProcessor.parameters.getParameter(Params::PostGain), "dB"),
+    distortionMix       (audioProcessor.parameters.getParameter(Params::Mix), ""),
+    lowCutSlopeSelect   (audioProcessor.parameters.getParameter(Params::LowCutSlope), "dB/Oct"),
+    highCutSlopeSelect  (audioProcessor.parameters.getParameter(Params::HighCutSlope), "dB/Oct"),
 
     responseCurveComponent      (audioProcessor),
-    lowCutFreqSliderAttachment  (audioProcessor.apvts, "LowCut Freq", lowCutFreqSlider),
-    highCutFreqSliderAttachment (audioProcessor.apvts, "HighCut Freq", highCutFreqSlider),
-    driveSliderAttachment       (audioProcessor.apvts, "Drive", driveSlider),
-    postGainSliderAttachment    (audioProcessor.apvts, "Post Gain", postGainSlider),
-    distortionMixAttachment     (audioProcessor.apvts, "Mix", distortionMix),
-    lowCutSlopeSelectAttachment (audioProcessor.apvts, "LowCut Slope", lowCutSlopeSelect),
-    highCutSlopeSelectAttachment(audioProcessor.apvts, "HighCut Slope", highCutSlopeSelect),
-
-    lowCutBypassButtonAttachment    (audioProcessor.apvts, "LowCut Bypassed", lowCutBypassButton),
-    highCutBypassButtonAttachment   (audioProcessor.apvts, "HighCut Bypassed", highCutBypassButton),
-    spectrumEnabledButtonAttachment (audioProcessor.apvts, "Spectrum Enabled", spectrumEnabledButton),
-    helpButtonAttachment            (audioProcessor.apvts, "Help Button", helpButton)
+    lowCutFreqSliderAttachment  (audioProcessor.apvts, Params::getID(Params::LowCutFreq), lowCutFreqSlider),
+    highCutFreqSliderAttachment (audioProcessor.apvts, Params::getID(Params::HighCutFreq), highCutFreqSlider),
+    driveSliderAttachment       (audioProcessor.apvts, Params::getID(Params::Drive), driveSlider),
+    postGainSliderAttachment    (audioProcessor.apvts, Params::getID(Params::PostGain), postGainSlider),
+    distortionMixAttachment     (audioProcessor.apvts, Params::getID(Params::Mix), distortionMix),
+    lowCutSlopeSelectAttachment (audioProcessor.apvts, Params::getID(Params::LowCutSlope), lowCutSlopeSelect),
+    highCutSlopeSelectAttachment(audioProcessor.apvts, Params::getID(Params::HighCutSlope), highCutSlopeSelect),
+
+    lowCutBypassButtonAttachment    (audioProcessor.apvts, Params::getID(Params::LowCutBypassed), lowCutBypassButton),
+    highCutBypassButtonAttachment   (audioProcessor.apvts, Params::getID(Params::HighCutBypassed), highCutBypassButton),
+    spectrumEnabledButtonAttachment (audioProcessor.apvts, Params::getID(Params::SpectrumEnabled), spectrumEnabledButton),
+    helpButtonAttachment            (audioProcessor.apvts, Params::getID(Params::HelpButton), helpButton)
 {
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
 
     //add waveform visualiser
-    addAndMakeVisible(audioProcessor.waveformViewer);
-    audioProcessor.waveformViewer.setColours(juce::Colours::black, juce::Colours::white);
-    //audioProcessor.waveformViewer.setColours(juce::Colour(10.f, 10.f, 10.f, 0.f), juce::Colours::white);
+    //scroll to zoom, alt-click to go back to the default window, click for the goniometer
+    addAndMakeVisible(waveformView);
+    addChildComponent(goniometer);
 
     //add each parameter
     for (auto* comp : getComps())
@@ -896,6 +1305,12 @@ CourseworkPluginAudioProcessorEditor::CourseworkPluginAudioProcessorEditor (Cour
     spectrumEnabledButton.setLookAndFeel(&lnf);
     helpButton.setLookAndFeel(&lnf);
 
+    //analyser settings
+    setupAnalyzerBox(analyzerResolutionBox, analyzerResolutionAttachment, Params::AnalyzerResolution, "Analyser FFT size");
+    setupAnalyzerBox(analyzerAveragingBox, analyzerAveragingAttachment, Params::AnalyzerAveraging, "Analyser averaging");
+    setupAnalyzerBox(analyzerHoldBox, analyzerHoldAttachment, Params::AnalyzerHold, "Analyser peak hold");
+    setupAnalyzerBox(analyzerOverlayBox, analyzerOverlayAttachment, Params::AnalyzerOverlay, "Analyser channels");
+    setupAnalyzerBox(analyzerViewBox, analyzerViewAttachment, Params::AnalyzerView, "Analyser display");
 
     auto safePtr = juce::Component::SafePointer<CourseworkPluginAudioProcessorEditor>(this);
     spectrumEnabledButton.onClick = [safePtr]()
@@ -920,10 +1335,45 @@ CourseworkPluginAudioProcessorEditor::CourseworkPluginAudioProcessorEditor (Cour
     addAndMakeVisible(verticalMeterL);
     addAndMakeVisible(verticalMeterR);
 
+   #if COURSEWORK_ENABLE_PROFILER
+    //hidden until P is pressed
+    addChildComponent(profilerOverlay);
+    setWantsKeyboardFocus(true);
+   #endif
+
+    //loudness readout, clicking it starts the integrated measurement again
+    addAndMakeVisible(loudnessReadout);
+    loudnessReadout.onReset = [safePtr]()
+    {
+        if (auto* comp = safePtr.getComponent())
+            comp->audioProcessor.loudnessMeter.requestReset();
+    };
+
+    //loaded once, it's drawn into the static layer
+    background = juce::ImageCache::getFromMemory(BinaryData::bg_png, BinaryData::bg_pngSize);
+    setOpaque(true);
+
     //plugin size
     setSize (820, 445);
 
-    startTimerHz(60);
+    //start capturing for the waveform viewer and the meters
+    setShowingGoniometer(false);
+    meterSubscription = audioProcessor.captureRegistry.subscribe(CaptureStream::Meters);
+
+    waveformView.onClick = [safePtr]()
+    {
+        if (auto* comp = safePtr.getComponent())
+            comp->setShowingGoniometer(true);
+    };
+    goniometer.onClick = [safePtr]()
+    {
+        if (auto* comp = safePtr.getComponent())
+            comp->setShowingGoniometer(false);
+    };
+
+    //one vblank driven clock paces the meters, the waveform and the analyser
+    frameClock.addClient(&responseCurveComponent);
+    frameClock.addClient(this);
 }
 
 CourseworkPluginAudioProcessorEditor::~CourseworkPluginAudioProcessorEditor()
@@ -934,20 +1384,127 @@ CourseworkPluginAudioProcessorEditor::~CourseworkPluginAudioProcessorEditor()
     helpButton.setLookAndFeel(nullptr);
 }
 
-void CourseworkPluginAudioProcessorEditor::timerCallback()
+void CourseworkPluginAudioProcessorEditor::setupAnalyzerBox(juce::ComboBox& box,
+    std::unique_ptr<ComboBoxAttachment>& attachment,
+    Params::Id parameter,
+    const juce::String& tooltip)
 {
-    verticalMeterL.setLevel(audioProcessor.getRmsValue(0));
-    verticalMeterR.setLevel(audioProcessor.getRmsValue(1));
-    verticalMeterL.repaint();
-    verticalMeterR.repaint();
+    //items are added before the attachment so it can select the current choice
+    box.addItemList(audioProcessor.parameters.getParameter(parameter).getAllValueStrings(), 1);
+    box.setTooltip(tooltip);
+    box.setColour(juce::ComboBox::backgroundColourId, juce::Colours::black);
+    box.setColour(juce::ComboBox::outlineColourId, juce::Colours::white);
+    attachment = std::make_unique<ComboBoxAttachment>(audioProcessor.apvts, Params::getID(parameter), box);
+    addAndMakeVisible(box);
+}
+
+void CourseworkPluginAudioProcessorEditor::setShowingGoniometer(bool shouldShow)
+{
+    showingGoniometer = shouldShow;
+
+    waveformView.setVisible(!shouldShow);
+    goniometer.setVisible(shouldShow);
+
+    if (shouldShow)
+        goniometer.reset();
+
+    //swap the subscriptions so only the visible panel costs anything on the audio thread
+    waveformSubscription = shouldShow ? CaptureRegistry::Subscription() : audioProcessor.captureRegistry.subscribe(CaptureStream::Waveform);
+    stereoSubscription = shouldShow ? audioProcessor.captureRegistry.subscribe(CaptureStream::Stereo) : CaptureRegistry::Subscription();
 }
 
+bool CourseworkPluginAudioProcessorEditor::frameTick()
+{
+    //the meters repaint themselves when their level moves
+    //the last snapshot is kept while the processor has nothing new
+    audioProcessor.readTelemetry(telemetry);
+
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+    const auto seconds = lastFrameTime > 0.0 ? float((now - lastFrameTime) / 1000.0) : 0.f;
+    lastFrameTime = now;
+
+    auto updateMeter = [seconds](Gui::VerticalMeter& meter, Gui::MeterBallistics& ballistics, const Dsp::TelemetrySnapshot::Channel& channel)
+    {
+        const auto moved = meter.setLevel(ballistics.process(channel.rms, seconds));
+        const auto clipChanged = meter.setClipped(ballistics.processClips(channel.clipCount, seconds));
+        return moved || clipChanged;
+    };
+
+    const auto leftMoved = updateMeter(verticalMeterL, meterBallistics[0], telemetry.channels[0]);
+    const auto rightMoved = updateMeter(verticalMeterR, meterBallistics[1], telemetry.channels[1]);
+
+    //only the visible panel is updated, the other one isn't being captured
+    const auto waveformMoved = showingGoniometer ? goniometer.update() : waveformView.update();
+
+    const auto& loudness = audioProcessor.loudnessMeter;
+    const auto loudnessMoved = loudnessReadout.setReadings(loudness.getMomentary(),
+        loudness.getShortTerm(),
+        loudness.getIntegrated(),
+        loudness.getTruePeak());
+
+   #if COURSEWORK_ENABLE_PROFILER
+    if (profilerOverlay.isVisible())
+        profilerOverlay.update();
+   #endif
+
+    //a still meter means silence, which lets the clock slow down
+    return leftMoved || rightMoved || waveformMoved || loudnessMoved;
+}
+
+#if COURSEWORK_ENABLE_PROFILER
+bool CourseworkPluginAudioProcessorEditor::keyPressed(const juce::KeyPress& key)
+{
+    const auto character = juce::CharacterFunctions::toUpperCase(key.getTextCharacter());
+
+    if (character == 'P')
+    {
+        profilerOverlay.setVisible(!profilerOverlay.isVisible());
+        return true;
+    }
+
+    if (character == 'R')
+    {
+        audioProcessor.profiler.requestReset();
+        return true;
+    }
+
+    if (character == 'D')
+    {
+        //timestamped so earlier dumps aren't overwritten
+        auto file = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+            .getChildFile("courseworkPlugin-profile-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") + ".json");
+
+        if (!audioProcessor.profiler.writeReport(file))
+            DBG("couldn't write the profiler report to " + file.getFullPathName());
+
+        return true;
+    }
+
+    return false;
+}
+#endif
+
 void CourseworkPluginAudioProcessorEditor::paint(juce::Graphics& g)
+{
+    Gui::ScopedPaintTimer paintTimer(*this);
+
+    //everything the editor draws itself is static, so it's rendered once per size
+    //and display scale and then only blitted
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (staticLayer.isNull() || scale != staticLayerScale)
+    {
+        staticLayer = renderScaledLayer(getWidth(), getHeight(), scale, [this](juce::Graphics& lg) { drawStaticLayer(lg); });
+        staticLayerScale = scale;
+    }
+
+    g.drawImage(staticLayer, getLocalBounds().toFloat());
+}
+
+void CourseworkPluginAudioProcessorEditor::drawStaticLayer(juce::Graphics& g)
 {
     using namespace juce;
 
     g.fillAll(Colours::black);
-    background = juce::ImageCache::getFromMemory(BinaryData::bg_png, BinaryData::bg_pngSize);
     g.drawImageWithin(background, 0, 0, getWidth(), getHeight(), juce::RectanglePlacement::stretchToFit);
 
     auto bounds = getLocalBounds().withSizeKeepingCentre(800, 425);
@@ -971,7 +1528,6 @@ void CourseworkPluginAudioProcessorEditor::paint(juce::Graphics& g)
     auto spectrumArea = visualiserArea.removeFromLeft(485);
     auto waveformArea = visualiserArea.removeFromRight(285);
     auto meterArea = visualiserArea;
-    audioProcessor.waveformViewer.setBounds(waveformArea.withSizeKeepingCentre(283, 100));
     auto waveformBounds = waveformArea.withSizeKeepingCentre(285, 120);
 
     auto filterArea = bounds.removeFromLeft(bounds.getWidth() * 0.5);
@@ -1071,6 +1627,8 @@ void CourseworkPluginAudioProcessorEditor::resized()
     // This is generally where you'll want to lay out the positions of any
     // subcomponents in your editor..
 
+    staticLayer = juce::Image();
+
     //making bounds for everything
     auto bounds = getLocalBounds().withSizeKeepingCentre(800, 425);
 
@@ -1088,12 +1646,43 @@ void CourseworkPluginAudioProcessorEditor::resized()
     helpButtonArea.setY(14);
     helpButton.setBounds(helpButtonArea);
 
+    auto analyzerResolutionArea = helpButtonArea;
+    analyzerResolutionArea.setX(helpButtonArea.getRight() + 10);
+    analyzerResolutionArea.setWidth(70);
+    analyzerResolutionBox.setBounds(analyzerResolutionArea);
+
+    auto analyzerAveragingArea = analyzerResolutionArea.translated(analyzerResolutionArea.getWidth() + 10, 0);
+    analyzerAveragingBox.setBounds(analyzerAveragingArea);
+
+    auto analyzerHoldArea = analyzerAveragingArea.translated(analyzerAveragingArea.getWidth() + 10, 0);
+    analyzerHoldArea.setWidth(90);
+    analyzerHoldBox.setBounds(analyzerHoldArea);
+
+    auto analyzerOverlayArea = analyzerHoldArea.translated(analyzerHoldArea.getWidth() + 10, 0);
+    analyzerOverlayBox.setBounds(analyzerOverlayArea);
+
+    auto analyzerViewArea = analyzerOverlayArea.translated(analyzerOverlayArea.getWidth() + 10, 0);
+    analyzerViewBox.setBounds(analyzerViewArea);
+
+    //the loudness readout takes the rest of the top bar
+    auto loudnessArea = analyzerViewArea.withLeft(analyzerViewArea.getRight() + 10).withRight(getWidth() - 10);
+    loudnessReadout.setBounds(loudnessArea);
+
     auto visualiserArea = bounds.removeFromTop(bounds.getHeight() * 0.375);
     auto spectrumArea = visualiserArea.removeFromLeft(485);
     auto waveformArea = visualiserArea.removeFromRight(295);
     auto meterArea = visualiserArea;
 
-    //audioProcessor.waveformViewer.setBounds(waveformArea);
+    //the viewer sits inside the 285px wide frame drawn by drawStaticLayer()
+    auto waveformFrame = getLocalBounds().withSizeKeepingCentre(800, 425).withTrimmedTop(25);
+    waveformFrame = waveformFrame.removeFromTop(waveformFrame.getHeight() * 0.375).withTrimmedLeft(485);
+    waveformView.setBounds(waveformFrame.removeFromRight(285).withSizeKeepingCentre(283, 100));
+    goniometer.setBounds(waveformView.getBounds());
+
+   #if COURSEWORK_ENABLE_PROFILER
+    //over the top left of the analyser
+    profilerOverlay.setBounds(spectrumArea.getX() + 10, spectrumArea.getY() + 10, 270, 120);
+   #endif
 
     responseCurveComponent.setBounds(spectrumArea);
 
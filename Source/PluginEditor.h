@@ -11,6 +11,11 @@
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
 #include "Component//VerticalMeter.h"
+#include "Component//FrameClock.h"
+#include "Component//WaveformView.h"
+#include "Component//LoudnessReadout.h"
+#include "Component//Goniometer.h"
+#include "Component//ProfilerOverlay.h"
 
 enum FFTOrder
 {
@@ -19,89 +24,345 @@ enum FFTOrder
     order8192 = 13
 };
 
-//produces FFT data from an audio buffer
+/*
+ two real signals packed into one complex FFT (the first as the real part, the
+ second as the imaginary part) are separated again with the conjugate symmetry
+ of real spectra:
+    A[k] = (X[k] + conj(X[N - k])) / 2
+    B[k] = (X[k] - conj(X[N - k])) / 2i
+ the magnitudes are normalised and written out in decibels.
+ */
+inline void separatePackedSpectra(const juce::dsp::Complex<float>* spectrum,
+    int fftSize,
+    float* firstOut,
+    float* secondOut,
+    float negativeInfinity)
+{
+    const int numBins = fftSize / 2;
+
+    auto toDecibels = [numBins, negativeInfinity](float v)
+    {
+        v = (!std::isinf(v) && !std::isnan(v)) ? v / float(numBins) : 0.f;
+        return juce::Decibels::gainToDecibels(v, negativeInfinity);
+    };
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        const auto x = spectrum[k];
+        const auto mirrored = std::conj(spectrum[(fftSize - k) & (fftSize - 1)]);
+
+        firstOut[k] = toDecibels(std::abs(x + mirrored) * 0.5f);
+        secondOut[k] = toDecibels(std::abs(x - mirrored) * 0.5f);
+    }
+}
+
+//produces FFT data for two audio buffers at once
 template<typename BlockType>
 struct FFTDataGenerator
 {
+    static constexpr int minOrder = FFTOrder::order2048;
+    static constexpr int maxOrder = FFTOrder::order8192;
+    static constexpr int numOrders = maxOrder - minOrder + 1;
+    static constexpr int maxFFTSize = 1 << maxOrder;
+
+    FFTDataGenerator()
+    {
+        //every order gets its FFT engine and window up front
+        //so switching resolution later never allocates
+        for (int i = 0; i < numOrders; ++i)
+        {
+            const auto fftOrder = minOrder + i;
+            forwardFFTs[i] = std::make_unique<juce::dsp::FFT>(fftOrder);
+            windows[i] = std::make_unique<juce::dsp::WindowingFunction<float>>(1 << fftOrder, juce::dsp::WindowingFunction<float>::blackmanHarris);
+        }
+
+        //fftData, the scratch buffers and the fifo are sized for the largest order
+        fftData.resize(maxFFTSize * 2, 0);
+        windowedFirst.resize(maxFFTSize, 0);
+        windowedSecond.resize(maxFFTSize, 0);
+        packed.resize(maxFFTSize);
+        spectrum.resize(maxFFTSize);
+        fftDataFifo.prepare(fftData.size());
+    }
+
     /**
-     produces the FFT data from an audio buffer.
+     produces the FFT data from two audio buffers.
+     the most recent getFFTSize() samples of each buffer are analysed with a single
+     complex transform. the first buffer's bins are at the start of the block,
+     the second buffer's bins follow straight after.
      */
-    void produceFFTDataForRendering(const juce::AudioBuffer<float>& audioData, const float negativeInfinity)
+    void produceFFTDataForRendering(const juce::AudioBuffer<float>& firstData,
+        const juce::AudioBuffer<float>& secondData,
+        const float negativeInfinity)
     {
         const auto fftSize = getFFTSize();
+        jassert(firstData.getNumSamples() >= fftSize && secondData.getNumSamples() >= fftSize);
 
-        fftData.assign(fftData.size(), 0);
-        auto* readIndex = audioData.getReadPointer(0);
-        std::copy(readIndex, readIndex + fftSize, fftData.begin());
+        auto* first = firstData.getReadPointer(0, firstData.getNumSamples() - fftSize);
+        auto* second = secondData.getReadPointer(0, secondData.getNumSamples() - fftSize);
+        std::copy(first, first + fftSize, windowedFirst.begin());
+        std::copy(second, second + fftSize, windowedSecond.begin());
 
         // first apply a windowing function to our data
-        window->multiplyWithWindowingTable(fftData.data(), fftSize);       // [1]
-
-        // then render our FFT data..
-        forwardFFT->performFrequencyOnlyForwardTransform(fftData.data());  // [2]
+        getWindow().multiplyWithWindowingTable(windowedFirst.data(), fftSize);       // [1]
+        getWindow().multiplyWithWindowingTable(windowedSecond.data(), fftSize);
 
-        int numBins = (int)fftSize / 2;
+        for (int i = 0; i < fftSize; ++i)
+            packed[i] = { windowedFirst[i], windowedSecond[i] };
 
-        //normalize the fft values.
-        for (int i = 0; i < numBins; ++i)
-        {
-            auto v = fftData[i];
-            //            fftData[i] /= (float) numBins;
-            if (!std::isinf(v) && !std::isnan(v))
-            {
-                v /= float(numBins);
-            }
-            else
-            {
-                v = 0.f;
-            }
-            fftData[i] = v;
-        }
+        // then render our FFT data..
+        getFFT().perform(packed.data(), spectrum.data(), false);  // [2]
 
-        //convert them to decibels
-        for (int i = 0; i < numBins; ++i)
-        {
-            fftData[i] = juce::Decibels::gainToDecibels(fftData[i], negativeInfinity);
-        }
+        //split the two channels and convert them to decibels
+        const int numBins = fftSize / 2;
+        separatePackedSpectra(spectrum.data(), fftSize, fftData.data(), fftData.data() + numBins, negativeInfinity);
 
         fftDataFifo.push(fftData);
     }
 
     void changeOrder(FFTOrder newOrder)
     {
-        //when you change order, recreate the window, forwardFFT, fifo, fftData
-        //also reset the fifoIndex
-        //things that need recreating should be created on the heap via std::make_unique<>
+        //everything was built in the constructor, so changing order only selects
+        //which FFT and window are used. the fifo may still hold blocks of the
+        //old order, so they are thrown away
+        jassert(newOrder >= minOrder && newOrder <= maxOrder);
 
-        order = newOrder;
-        auto fftSize = getFFTSize();
-
-        forwardFFT = std::make_unique<juce::dsp::FFT>(order);
-        window = std::make_unique<juce::dsp::WindowingFunction<float>>(fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris);
+        if (order == newOrder)
+            return;
 
-        fftData.clear();
-        fftData.resize(fftSize * 2, 0);
+        order = newOrder;
 
-        fftDataFifo.prepare(fftData.size());
+        while (fftDataFifo.pull(fftData)) {}
     }
     //==============================================================================
+    FFTOrder getOrder() const { return order; }
     int getFFTSize() const { return 1 << order; }
     int getNumAvailableFFTDataBlocks() const { return fftDataFifo.getNumAvailableForReading(); }
     //==============================================================================
     bool getFFTData(BlockType& fftData) { return fftDataFifo.pull(fftData); }
 private:
-    FFTOrder order;
+    FFTOrder order = FFTOrder::order4096;
     BlockType fftData;
-    std::unique_ptr<juce::dsp::FFT> forwardFFT;
-    std::unique_ptr<juce::dsp::WindowingFunction<float>> window;
+    std::vector<float> windowedFirst, windowedSecond;
+    std::vector<juce::dsp::Complex<float>> packed, spectrum;
+    std::array<std::unique_ptr<juce::dsp::FFT>, numOrders> forwardFFTs;
+    std::array<std::unique_ptr<juce::dsp::WindowingFunction<float>>, numOrders> windows;
+
+    juce::dsp::FFT& getFFT() { return *forwardFFTs[order - minOrder]; }
+    juce::dsp::WindowingFunction<float>& getWindow() { return *windows[order - minOrder]; }
 
     Fifo<BlockType> fftDataFifo;
 };
 
+//smooths FFT frames over time and keeps a decaying peak trace for every bin
+struct SpectrumBallistics
+{
+    enum HoldMode
+    {
+        HoldOff,
+        PeakHold,
+        InfiniteHold
+    };
+
+    void prepare(int maxNumBins, float negativeInfinity)
+    {
+        averaged.resize(maxNumBins);
+        peak.resize(maxNumBins);
+        holdRemaining.resize(maxNumBins);
+        reset(negativeInfinity);
+    }
+
+    void reset(float negativeInfinity)
+    {
+        std::fill(averaged.begin(), averaged.end(), negativeInfinity);
+        std::fill(peak.begin(), peak.end(), negativeInfinity);
+        std::fill(holdRemaining.begin(), holdRemaining.end(), 0.f);
+        hasHistory = false;
+    }
+
+    void setAveragingTime(float seconds) { averagingTime = seconds; }
+    void setHoldMode(HoldMode newMode) { holdMode = newMode; }
+    HoldMode getHoldMode() const { return holdMode; }
+
+    /**
+     folds one frame of dB values into the averaged and peak traces.
+     frameSeconds is the time since the previous frame.
+     */
+    void process(const float* frame, int numBins, float frameSeconds)
+    {
+        jassert(numBins <= (int)averaged.size());
+
+        //exponential average: avg = avg * a + frame * (1 - a)
+        if (averagingTime > 0.f && hasHistory)
+        {
+            const auto a = std::exp(-frameSeconds / averagingTime);
+            juce::FloatVectorOperations::multiply(averaged.data(), a, numBins);
+            juce::FloatVectorOperations::addWithMultiply(averaged.data(), frame, 1.f - a, numBins);
+        }
+        else
+        {
+            juce::FloatVectorOperations::copy(averaged.data(), frame, numBins);
+        }
+
+        hasHistory = true;
+
+        if (holdMode == HoldOff)
+            return;
+
+        //one pass: catch new peaks, count down the hold time, then let the peak fall
+        const auto decay = holdMode == InfiniteHold ? 0.f : peakDecayPerSecond * frameSeconds;
+        const auto hold = holdMode == InfiniteHold ? std::numeric_limits<float>::max() : peakHoldSeconds;
+
+        auto* avg = averaged.data();
+        auto* pk = peak.data();
+        auto* remaining = holdRemaining.data();
+
+        for (int i = 0; i < numBins; ++i)
+        {
+            const auto rising = avg[i] >= pk[i];
+            remaining[i] = rising ? hold : remaining[i] - frameSeconds;
+            const auto decayed = remaining[i] > 0.f ? pk[i] : pk[i] - decay;
+            pk[i] = juce::jmax(avg[i], decayed);
+        }
+    }
+
+    const std::vector<float>& getAveraged() const { return averaged; }
+    const std::vector<float>& getPeak() const { return peak; }
+private:
+    static constexpr float peakHoldSeconds = 1.f;
+    static constexpr float peakDecayPerSecond = 12.f;   //dB per second
+
+    std::vector<float> averaged, peak, holdRemaining;
+    float averagingTime = 0.f;
+    HoldMode holdMode = HoldOff;
+    bool hasHistory = false;
+};
+
+//one spectrum that feeds the path generator. sources are ordered from the highest
+//band down, each one drawing the columns at or above its lowest frequency
+struct SpectrumSource
+{
+    const float* data = nullptr;
+    int numBins = 0;
+    float binWidth = 0.f;
+    float minFrequency = 0.f;
+};
+
+/*
+ maps evenly spaced steps along a log frequency axis (10 Hz to 20 kHz) to the
+ bins that fall inside each step. the path generator uses one step per pixel
+ column and the spectrogram one per pixel row. the table only depends on the
+ number of steps and the bin layout of the sources, so it's rebuilt when they change.
+ */
+struct LogFrequencyBinMap
+{
+    static constexpr int maxSources = 8;
+
+    //returns true if the table had to be rebuilt
+    bool update(const SpectrumSource* sources, int numSources, int numSteps)
+    {
+        jassert(numSources > 0 && numSources <= maxSources);
+
+        auto layoutMatches = [this, sources, numSources]()
+        {
+            for (int i = 0; i < numSources; ++i)
+            {
+                const auto& a = mappedSources[i];
+                const auto& b = sources[i];
+
+                if (a.numBins != b.numBins || a.binWidth != b.binWidth || a.minFrequency != b.minFrequency)
+                    return false;
+            }
+            return true;
+        };
+
+        if (numSteps == getNumSteps() && numSources == mappedNumSources && layoutMatches())
+            return false;
+
+        mappedNumSources = numSources;
+        std::copy(sources, sources + numSources, mappedSources.begin());
+
+        steps.resize(juce::jmax(numSteps, 0));
+
+        auto freqAt = [numSteps](float x)
+        {
+            return juce::mapToLog10(x / float(numSteps), 10.f, 20000.f);
+        };
+
+        for (int x = 0; x < numSteps; ++x)
+        {
+            auto& step = steps[x];
+
+            //the first source whose band reaches down to this step draws it
+            step.source = numSources - 1;
+            for (int i = 0; i < numSources; ++i)
+            {
+                if (freqAt(x + 0.5f) >= sources[i].minFrequency)
+                {
+                    step.source = i;
+                    break;
+                }
+            }
+
+            const auto numBins = sources[step.source].numBins;
+            const auto binWidth = sources[step.source].binWidth;
+
+            //bins whose frequency falls inside this step
+            auto first = juce::jlimit(1, numBins, (int)std::ceil(freqAt(float(x)) / binWidth));
+            auto last = juce::jlimit(1, numBins, (int)std::ceil(freqAt(float(x + 1)) / binWidth));
+
+            if (last > first)
+            {
+                step.firstBin = first;
+                step.numBins = last - first;
+                step.fraction = 0.f;
+            }
+            else
+            {
+                auto binPos = juce::jlimit(0.f, float(numBins - 2), freqAt(x + 0.5f) / binWidth);
+                step.firstBin = juce::jmin((int)binPos, numBins - 2);
+                step.numBins = 0;
+                step.fraction = binPos - float(step.firstBin);
+            }
+        }
+
+        return true;
+    }
+
+    int getNumSteps() const { return static_cast<int>(steps.size()); }
+
+    //steps that span several bins take the loudest of them,
+    //steps narrower than a bin interpolate between the two nearest bins
+    float read(const SpectrumSource* sources, int index) const
+    {
+        const auto& step = steps[index];
+        const auto* bins = sources[step.source].data + step.firstBin;
+
+        return step.numBins > 0
+            ? juce::FloatVectorOperations::findMaximum(bins, step.numBins)
+            : bins[0] + (bins[1] - bins[0]) * step.fraction;
+    }
+private:
+    //range of bins that land in one step
+    struct StepBins
+    {
+        int source = 0;
+        int firstBin = 0;
+        int numBins = 0;        //0 means interpolate from firstBin to firstBin + 1
+        float fraction = 0.f;
+    };
+
+    std::vector<StepBins> steps;
+    int mappedNumSources = 0;
+    std::array<SpectrumSource, maxSources> mappedSources;
+};
+
 //path generator from FFT data
 template<typename PathType>
 struct AnalyzerPathGenerator
 {
+    static constexpr int maxSources = LogFrequencyBinMap::maxSources;
+
     /*
      converts 'renderData[]' into a juce::Path
      */
@@ -110,15 +371,33 @@ struct AnalyzerPathGenerator
         int fftSize,
         float binWidth,
         float negativeInfinity)
+    {
+        SpectrumSource source;
+        source.data = renderData.data();
+        source.numBins = fftSize / 2;
+        source.binWidth = binWidth;
+
+        generatePath(&source, 1, fftBounds, negativeInfinity);
+    }
+
+    /*
+     converts several spectra stitched on the log frequency axis into a juce::Path
+     every pixel column gets exactly one vertex, see LogFrequencyBinMap
+     */
+    void generatePath(const SpectrumSource* sources,
+        int numSources,
+        juce::Rectangle<float> fftBounds,
+        float negativeInfinity)
     {
         auto top = fftBounds.getY();
         auto bottom = fftBounds.getHeight();
-        auto width = fftBounds.getWidth();
 
-        int numBins = (int)fftSize / 2;
+        columns.update(sources, numSources, static_cast<int>(fftBounds.getWidth()));
+
+        const auto numColumns = columns.getNumSteps();
 
         PathType p;
-        p.preallocateSpace(3 * (int)fftBounds.getWidth());
+        p.preallocateSpace(3 * numColumns + 3);
 
         auto map = [bottom, top, negativeInfinity](float v)
         {
@@ -127,29 +406,18 @@ struct AnalyzerPathGenerator
                 float(bottom + 10), top);
         };
 
-        auto y = map(renderData[0]);
-
-        //        jassert( !std::isnan(y) && !std::isinf(y) );
-        if (std::isnan(y) || std::isinf(y))
-            y = bottom;
-
-        p.startNewSubPath(0, y);
-
-        const int pathResolution = 2; //you can draw line-to's every 'pathResolution' pixels.
-
-        for (int binNum = 1; binNum < numBins; binNum += pathResolution)
+        for (int x = 0; x < numColumns; ++x)
         {
-            y = map(renderData[binNum]);
+            auto y = map(columns.read(sources, x));
 
             //            jassert( !std::isnan(y) && !std::isinf(y) );
+            if (std::isnan(y) || std::isinf(y))
+                y = bottom;
 
-            if (!std::isnan(y) && !std::isinf(y))
-            {
-                auto binFreq = binNum * binWidth;
-                auto normalizedBinX = juce::mapFromLog10(binFreq, 10.f, 20000.f);
-                int binX = std::floor(normalizedBinX * width);
-                p.lineTo(binX, y);
-            }
+            if (x == 0)
+                p.startNewSubPath(0, y);
+            else
+                p.lineTo(x, y);
         }
 
         pathFifo.push(p);
@@ -165,9 +433,344 @@ struct AnalyzerPathGenerator
         return pathFifo.pull(path);
     }
 private:
+    //one step per pixel column
+    LogFrequencyBinMap columns;
+
     Fifo<PathType> pathFifo;
 };
 
+/*
+ scrolling spectrogram kept in a circular image. every analysis frame writes
+ one pixel column at the write position through a row to bin table and a
+ colour lookup table, so a frame costs O(height) however long the history is.
+ drawing blits the two halves of the ring with an offset instead of redrawing.
+ */
+struct Spectrogram
+{
+    Spectrogram()
+    {
+        //black through blue, magenta and orange to a pale yellow
+        const std::array<juce::Colour, 5> stops
+        {
+            juce::Colour(0xff000000), juce::Colour(0xff1b0c5a), juce::Colour(0xffa12a7c),
+            juce::Colour(0xfff3771d), juce::Colour(0xfffcfdbf)
+        };
+
+        for (int i = 0; i < lutSize; ++i)
+        {
+            const auto position = float(i) / float(lutSize - 1) * float(stops.size() - 1);
+            const auto index = juce::jmin((int)position, (int)stops.size() - 2);
+
+            lut[i] = stops[index].interpolatedWith(stops[index + 1], position - float(index)).getPixelARGB();
+        }
+    }
+
+    //one column per pixel of history, one row per pixel of height
+    void prepare(int width, int height)
+    {
+        if (image.isValid() && image.getWidth() == width && image.getHeight() == height)
+            return;
+
+        image = juce::Image();
+        if (width > 0 && height > 0)
+            image = juce::Image(juce::Image::RGB, width, height, true);
+
+        writeColumn = 0;
+    }
+
+    void clear()
+    {
+        if (image.isValid())
+            image.clear(image.getBounds());
+
+        writeColumn = 0;
+    }
+
+    //writes the next column, row 0 is the top of the frequency axis
+    void addColumn(const SpectrumSource* sources, int numSources, float negativeInfinity)
+    {
+        if (!image.isValid())
+            return;
+
+        const auto height = image.getHeight();
+        rows.update(sources, numSources, height);
+
+        juce::Image::BitmapData bitmap(image, writeColumn, 0, 1, height, juce::Image::BitmapData::writeOnly);
+
+        //some platforms keep RGB images as ARGB
+        const auto isRGB = bitmap.pixelFormat == juce::Image::RGB;
+
+        for (int y = 0; y < height; ++y)
+        {
+            const auto level = rows.read(sources, height - 1 - y);
+            const auto index = juce::jlimit(0, lutSize - 1, (int)juce::jmap(level, negativeInfinity, 0.f, 0.f, float(lutSize - 1)));
+            auto* pixel = bitmap.getPixelPointer(0, y);
+
+            if (isRGB)
+                reinterpret_cast<juce::PixelRGB*>(pixel)->set(lut[index]);
+            else
+                reinterpret_cast<juce::PixelARGB*>(pixel)->set(lut[index]);
+        }
+
+        writeColumn = (writeColumn + 1) % image.getWidth();
+    }
+
+    //the oldest column is at the write position, so the ring is drawn in two parts
+    void draw(juce::Graphics& g, juce::Rectangle<int> area) const
+    {
+        if (!image.isValid())
+            return;
+
+        const auto width = image.getWidth();
+        const auto height = image.getHeight();
+        const auto olderWidth = width - writeColumn;
+
+        g.drawImage(image, area.getX(), area.getY(), olderWidth, area.getHeight(), writeColumn, 0, olderWidth, height);
+
+        if (writeColumn > 0)
+            g.drawImage(image, area.getX() + olderWidth, area.getY(), writeColumn, area.getHeight(), 0, 0, writeColumn, height);
+    }
+private:
+    static constexpr int lutSize = 256;
+
+    std::array<juce::PixelARGB, lutSize> lut;
+
+    //one step per pixel row
+    LogFrequencyBinMap rows;
+
+    juce::Image image;
+    int writeColumn = 0;
+};
+
+//halfband lowpass that halves the sample rate, used to feed the lower analyser bands
+struct HalfBandDecimator
+{
+    static constexpr int numTaps = 63;
+
+    HalfBandDecimator()
+    {
+        //windowed sinc with the cutoff at a quarter of the input rate,
+        //every other tap apart from the centre one is zero
+        std::array<float, numTaps> coefficients;
+        float sum = 0.f;
+
+        for (int n = 0; n < numTaps; ++n)
+        {
+            const auto m = n - centre;
+            const auto window = 0.42 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * n / (numTaps - 1))
+                + 0.08 * std::cos(2.0 * juce::MathConstants<double>::twoPi * n / (numTaps - 1));
+
+            double h = 0.0;
+            if (m == 0)
+                h = 0.5;
+            else if (m % 2 != 0)
+                h = std::sin(juce::MathConstants<double>::halfPi * m) / (juce::MathConstants<double>::pi * m);
+
+            coefficients[n] = float(h * window);
+            sum += coefficients[n];
+        }
+
+        //only the nonzero taps are kept: the ones an odd distance from the centre, which are
+        //the even ones since the centre is odd, and the centre itself
+        for (int k = 0; k < numSideTaps; ++k)
+            sideTaps[k] = coefficients[2 * k] / sum;
+
+        centreTap = coefficients[centre] / sum;
+
+        reset();
+    }
+
+    void reset()
+    {
+        history.fill(0.f);
+        writeIndex = 0;
+        skipNext = false;
+    }
+
+    //returns true when an output sample was produced
+    bool push(float input, float& output)
+    {
+        //the history is stored twice so the taps can always be read in one run
+        history[writeIndex] = input;
+        history[writeIndex + numTaps] = input;
+        writeIndex = (writeIndex + 1) % numTaps;
+
+        skipNext = !skipNext;
+        if (!skipNext)
+            return false;
+
+        const auto* x = history.data() + writeIndex;
+        float acc = centreTap * x[centre];
+        for (int k = 0; k < numSideTaps; ++k)
+            acc += sideTaps[k] * x[2 * k];
+
+        output = acc;
+        return true;
+    }
+private:
+    static constexpr int centre = numTaps / 2;
+    static constexpr int numSideTaps = numTaps / 2 + 1;
+    static_assert(centre % 2 != 0, "the side taps are assumed to be at the even indices");
+
+    std::array<float, numSideTaps> sideTaps;
+    float centreTap = 0.f;
+    std::array<float, numTaps * 2> history;
+    int writeIndex = 0;
+    bool skipNext = false;
+};
+
+/*
+ constant-Q-like analyser: the input is split into octave spaced bands by a chain
+ of halfband decimators and every band runs the same small FFT. lower bands get
+ finer bins because their sample rate is lower, and they update less often
+ because they fill more slowly.
+ two channels are analysed together, packed into one complex FFT per band.
+ */
+struct MultiResolutionAnalyzer
+{
+    static constexpr int numChannels = 2;
+    static constexpr int numStages = 5;
+    static constexpr int stageOrder = FFTOrder::order2048;
+    static constexpr int stageSize = 1 << stageOrder;
+    static constexpr int numBins = stageSize / 2;
+    static constexpr int hopSize = stageSize / 4;
+
+    //a band is trusted up to this fraction of its sample rate, above that
+    //the decimator's transition band starts
+    static constexpr float usableBandwidth = 0.4f;
+
+    MultiResolutionAnalyzer() :
+        forwardFFT(stageOrder),
+        window(stageSize, juce::dsp::WindowingFunction<float>::blackmanHarris)
+    {
+        for (auto& w : windowed)
+            w.resize(stageSize, 0);
+
+        packed.resize(stageSize);
+        spectrum.resize(stageSize);
+
+        for (auto& stage : stages)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                stage.history[ch].resize(stageSize, 0);
+                stage.spectrum[ch].resize(numBins, 0);
+            }
+        }
+    }
+
+    void reset(float negativeInfinity)
+    {
+        for (auto& stage : stages)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                std::fill(stage.history[ch].begin(), stage.history[ch].end(), 0.f);
+                std::fill(stage.spectrum[ch].begin(), stage.spectrum[ch].end(), negativeInfinity);
+                stage.decimators[ch].reset();
+            }
+
+            stage.writeIndex = 0;
+            stage.newSamples = 0;
+            stage.newFrames = 0;
+        }
+    }
+
+    //feeds both channels at the host rate, bands analyse themselves as they fill
+    void pushSamples(const float* first, const float* second, int numSamples, float negativeInfinity)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            pushIntoStage(0, first[i], second[i], negativeInfinity);
+    }
+
+    //number of frames a band produced since the last call, and clears it
+    int takeNewFrames(int stage)
+    {
+        auto frames = stages[stage].newFrames;
+        stages[stage].newFrames = 0;
+        return frames;
+    }
+
+    const std::vector<float>& getSpectrum(int stage, int channel) const { return stages[stage].spectrum[channel]; }
+
+    static double getStageSampleRate(int stage, double sampleRate) { return sampleRate / double(1 << stage); }
+
+    static double getStageBinWidth(int stage, double sampleRate) { return getStageSampleRate(stage, sampleRate) / double(stageSize); }
+
+    //lowest frequency a band is drawn for, the bottom band goes all the way down
+    static double getStageMinFrequency(int stage, double sampleRate)
+    {
+        return stage == numStages - 1 ? 0.0 : usableBandwidth * getStageSampleRate(stage + 1, sampleRate);
+    }
+private:
+    struct Stage
+    {
+        std::array<HalfBandDecimator, numChannels> decimators;
+        std::array<std::vector<float>, numChannels> history;
+        std::array<std::vector<float>, numChannels> spectrum;
+        int writeIndex = 0;
+        int newSamples = 0;
+        int newFrames = 0;
+    };
+
+    std::array<Stage, numStages> stages;
+
+    juce::dsp::FFT forwardFFT;
+    juce::dsp::WindowingFunction<float> window;
+    std::array<std::vector<float>, numChannels> windowed;
+    std::vector<juce::dsp::Complex<float>> packed, spectrum;
+
+    void pushIntoStage(int stageIndex, float first, float second, float negativeInfinity)
+    {
+        auto& stage = stages[stageIndex];
+
+        stage.history[0][stage.writeIndex] = first;
+        stage.history[1][stage.writeIndex] = second;
+        stage.writeIndex = (stage.writeIndex + 1) % stageSize;
+
+        if (++stage.newSamples >= hopSize)
+        {
+            stage.newSamples = 0;
+            analyse(stage, negativeInfinity);
+        }
+
+        if (stageIndex + 1 == numStages)
+            return;
+
+        //both decimators run in lockstep, so they produce output on the same sample
+        float decimatedFirst, decimatedSecond;
+        auto hasOutput = stage.decimators[0].push(first, decimatedFirst);
+        stage.decimators[1].push(second, decimatedSecond);
+
+        if (hasOutput)
+            pushIntoStage(stageIndex + 1, decimatedFirst, decimatedSecond, negativeInfinity);
+    }
+
+    void analyse(Stage& stage, float negativeInfinity)
+    {
+        //unroll the rings so the oldest sample comes first, then window them
+        const auto tail = stageSize - stage.writeIndex;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto& history = stage.history[ch];
+            std::copy(history.begin() + stage.writeIndex, history.end(), windowed[ch].begin());
+            std::copy(history.begin(), history.begin() + stage.writeIndex, windowed[ch].begin() + tail);
+
+            window.multiplyWithWindowingTable(windowed[ch].data(), stageSize);
+        }
+
+        for (int i = 0; i < stageSize; ++i)
+            packed[i] = { windowed[0][i], windowed[1][i] };
+
+        forwardFFT.perform(packed.data(), spectrum.data(), false);
+
+        separatePackedSpectra(spectrum.data(), stageSize, stage.spectrum[0].data(), stage.spectrum[1].data(), negativeInfinity);
+
+        ++stage.newFrames;
+    }
+};
+
 struct LookAndFeel : juce::LookAndFeel_V4
 {
     void drawLinearSlider(juce::Graphics&,
@@ -274,31 +877,218 @@ private:
     juce::String suffix;
 };
 
+//turns two sample fifos into spectrum paths, analysing both with one FFT
 struct PathProducer
 {
-    PathProducer(SingleChannelSampleFifo<CourseworkPluginAudioProcessor::BlockType>& scsf) :
-        leftChannelFifo(&scsf)
+    using SampleFifo = SingleChannelSampleFifo<CourseworkPluginAudioProcessor::BlockType>;
+    static constexpr int numChannels = 2;
+
+    PathProducer(SampleFifo& first, SampleFifo& second)
     {
-        leftChannelFFTDataGenerator.changeOrder(FFTOrder::order4096);
-        monoBuffer.setSize(1, leftChannelFFTDataGenerator.getFFTSize());
+        fftDataGenerator.changeOrder(FFTOrder::order4096);
+
+        fftData.resize(FFTDataGenerator<std::vector<float>>::maxFFTSize * 2, 0);
+
+        for (auto& channel : channels)
+        {
+            //the history holds enough samples for the largest order so a new
+            //resolution can be analysed straight away without reallocating
+            channel.history.setSize(1, FFTDataGenerator<std::vector<float>>::maxFFTSize);
+
+            channel.ballistics.prepare(FFTDataGenerator<std::vector<float>>::maxFFTSize / 2, negativeInfinity);
+
+            for (auto& stageBallistics : channel.multiResolutionBallistics)
+                stageBallistics.prepare(MultiResolutionAnalyzer::numBins, negativeInfinity);
+        }
+
+        spectrogramScratch.resize(maxSpectrogramSources * spectrogramScratchBins, negativeInfinity);
+
+        setSources(first, second);
     }
-    void process(juce::Rectangle<float>fftBounds, double sampleRate);
-    juce::Path getPath() { return leftChannelFFTPath; }
+    bool process(juce::Rectangle<float>fftBounds, double sampleRate);
+    void setSources(SampleFifo& first, SampleFifo& second);
+    //drops queued blocks and analysis state, for when capture starts again
+    void restart();
+    void setFFTOrder(FFTOrder newOrder);
+    void setMultiResolution(bool shouldUseMultiResolution);
+    void setBallistics(float averagingTime, SpectrumBallistics::HoldMode holdMode);
+    juce::Path getPath(int channel) const { return channels[channel].path; }
+    juce::Path getPeakPath(int channel) const { return channels[channel].peakPath; }
+    bool isShowingPeak() const { return channels[0].ballistics.getHoldMode() != SpectrumBallistics::HoldOff; }
+
+    //feeds the spectrogram from one channel, or from the louder of both when channel is -1
+    void setSpectrogram(bool enabled, juce::Rectangle<int> area, int channel);
+    const Spectrogram& getSpectrogram() const { return spectrogram; }
 private:
-    SingleChannelSampleFifo<CourseworkPluginAudioProcessor::BlockType>* leftChannelFifo;
+    static constexpr float negativeInfinity = -48.f;
+
+    struct ChannelState
+    {
+        SampleFifo* fifo = nullptr;
+
+        juce::AudioBuffer<float> history;
+
+        //reused between frames so processing doesn't allocate
+        juce::AudioBuffer<float> incoming;
+
+        SpectrumBallistics ballistics;
+        std::array<SpectrumBallistics, MultiResolutionAnalyzer::numStages> multiResolutionBallistics;
+
+        AnalyzerPathGenerator<juce::Path> pathGenerator, peakPathGenerator;
+
+        juce::Path path, peakPath;
+    };
+
+    std::array<ChannelState, numChannels> channels;
+
+    std::vector<float> fftData;
+
+    FFTDataGenerator<std::vector<float>> fftDataGenerator;
+
+    //samples between two FFT frames, used to time the ballistics
+    int hopSize = 0;
+
+    //octave band analyser used instead of the single FFT when multi-res is selected
+    bool multiResolution = false;
+    MultiResolutionAnalyzer multiResolutionAnalyzer;
 
-    juce::AudioBuffer<float> monoBuffer;
+    Spectrogram spectrogram;
+    bool spectrogramEnabled = false;
+    int spectrogramChannel = -1;
 
-    FFTDataGenerator<std::vector<float>> leftChannelFFTDataGenerator;
+    //both channels combined for the spectrogram, one slot per source
+    static constexpr int maxSpectrogramSources = MultiResolutionAnalyzer::numStages;
+    static constexpr int spectrogramScratchBins = FFTDataGenerator<std::vector<float>>::maxFFTSize / 2;
+    std::vector<float> spectrogramScratch;
 
-    AnalyzerPathGenerator<juce::Path> pathProducer;
+    using SpectrogramSources = std::array<SpectrumSource, maxSpectrogramSources>;
+    using SpectrogramData = std::array<std::array<const float*, maxSpectrogramSources>, numChannels>;
 
-    juce::Path leftChannelFFTPath;
+    //the sources hold the bin layout, the data the spectrum of each channel per source
+    void addSpectrogramColumn(SpectrogramSources& sources, int numSources, const SpectrogramData& data);
+
+    void resetAnalysis();
+    bool produceSingleResolutionPaths(juce::Rectangle<float> fftBounds, double sampleRate);
+    bool produceMultiResolutionPaths(juce::Rectangle<float> fftBounds, double sampleRate);
 };
 
+/*
+ evaluates the magnitude response of a cascade of first and second order sections
+ at a fixed set of frequencies. the cos/sin basis of every frequency is computed
+ once in prepare(), then each section is folded in for all frequencies at once
+ with SIMD registers.
+ */
+struct MagnitudeResponseEvaluator
+{
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    void prepare(const std::vector<double>& frequencies, double sampleRate)
+    {
+        preparedSampleRate = sampleRate;
+        numPoints = static_cast<int>(frequencies.size());
+        numPadded = (numPoints + (int)Vec::size() - 1) / (int)Vec::size() * (int)Vec::size();
+
+        storage.allocate(numPadded * numArrays + Vec::size(), true);
+        auto* base = Vec::getNextSIMDAlignedPtr(storage.get());
+
+        cosW = base;
+        sinW = cosW + numPadded;
+        cos2W = sinW + numPadded;
+        sin2W = cos2W + numPadded;
+        numerator = sin2W + numPadded;
+        denominator = numerator + numPadded;
+
+        for (int i = 0; i < numPadded; ++i)
+        {
+            //padding lanes evaluate at DC so they stay finite
+            const auto w = i < numPoints ? juce::MathConstants<double>::twoPi * frequencies[i] / sampleRate : 0.0;
+            cosW[i] = float(std::cos(w));
+            sinW[i] = float(std::sin(w));
+            cos2W[i] = float(std::cos(2.0 * w));
+            sin2W[i] = float(std::sin(2.0 * w));
+        }
+
+        reset();
+    }
+
+    //starts again from a flat response
+    void reset()
+    {
+        std::fill(numerator, numerator + numPadded, 1.f);
+        std::fill(denominator, denominator + numPadded, 1.f);
+    }
+
+    /**
+     folds one section into the response. the coefficients are laid out like
+     juce::dsp::IIR::Coefficients, b0 b1 b2 a1 a2 for second order sections
+     and b0 b1 a1 for first order ones, with a0 already normalised to 1.
+     */
+    void addSection(const float* coefficients, size_t numCoefficients)
+    {
+        jassert(numCoefficients == 3 || numCoefficients == 5);
+
+        const auto secondOrder = numCoefficients == 5;
+        const auto b0 = Vec::expand(coefficients[0]);
+        const auto b1 = Vec::expand(coefficients[1]);
+        const auto b2 = Vec::expand(secondOrder ? coefficients[2] : 0.f);
+        const auto a1 = Vec::expand(secondOrder ? coefficients[3] : coefficients[2]);
+        const auto a2 = Vec::expand(secondOrder ? coefficients[4] : 0.f);
+        const auto one = Vec::expand(1.f);
+
+        //|b0 + b1 e^-jw + b2 e^-j2w|^2, and the same for 1 + a1 e^-jw + a2 e^-j2w
+        for (int i = 0; i < numPadded; i += (int)Vec::size())
+        {
+            const auto c1 = Vec::fromRawArray(cosW + i);
+            const auto s1 = Vec::fromRawArray(sinW + i);
+            const auto c2 = Vec::fromRawArray(cos2W + i);
+            const auto s2 = Vec::fromRawArray(sin2W + i);
+
+            const auto numRe = b0 + b1 * c1 + b2 * c2;
+            const auto numIm = b1 * s1 + b2 * s2;
+            const auto denRe = one + a1 * c1 + a2 * c2;
+            const auto denIm = a1 * s1 + a2 * s2;
+
+            (Vec::fromRawArray(numerator + i) * (numRe * numRe + numIm * numIm)).copyToRawArray(numerator + i);
+            (Vec::fromRawArray(denominator + i) * (denRe * denRe + denIm * denIm)).copyToRawArray(denominator + i);
+        }
+    }
+
+    //the response in decibels, one value per frequency
+    void getDecibels(std::vector<double>& decibels) const
+    {
+        decibels.resize(numPoints);
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const auto power = denominator[i] > 0.f ? numerator[i] / denominator[i] : 0.f;
+            decibels[i] = juce::Decibels::gainToDecibels(std::sqrt(double(power)));
+        }
+    }
+
+    int getNumPoints() const { return numPoints; }
+    double getSampleRate() const { return preparedSampleRate; }
+private:
+    static constexpr int numArrays = 6;
+
+    double preparedSampleRate = 0.0;
+
+    juce::HeapBlock<float> storage;
+    float* cosW = nullptr;
+    float* sinW = nullptr;
+    float* cos2W = nullptr;
+    float* sin2W = nullptr;
+    float* numerator = nullptr;
+    float* denominator = nullptr;
+    int numPoints = 0, numPadded = 0;
+};
+
+//the offscreen paint benchmarks in Benchmarks/ time the editor's layers one by one,
+//the regression suite checks what the analyser repaints
+namespace Bench { class EditorBenchmarks; class RegressionSuite; }
+
 struct ResponseCurveComponent : juce::Component,
     juce::AudioProcessorParameter::Listener,
-    juce::Timer
+    Gui::FrameClock::Client
 {
     ResponseCurveComponent(CourseworkPluginAudioProcessor&);
     ~ResponseCurveComponent();
@@ -307,37 +1097,80 @@ struct ResponseCurveComponent : juce::Component,
 
     void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override { }
 
-    void timerCallback() override;
+    bool frameTick() override;
 
     void paint(juce::Graphics& g) override;
     void resized() override;
 
     void toggleSpectrumEnablement(bool enabled)
     {
+        //the processor stopped feeding the analyser while it was off,
+        //so anything still queued is stale
+        if (enabled && !shouldShowFFTAnalysis)
+            analyzerPathProducer.restart();
+
         shouldShowFFTAnalysis = enabled;
+        repaint(getRenderArea());
     }   
     void toggleHelpMenu(bool enabled)
     {
         showHelp = enabled;
+        repaint();
     }
 private:
     CourseworkPluginAudioProcessor& audioProcessor;
     juce::Atomic<bool> parametersChanged{ false };
 
+    std::atomic<float>* analyzerResolution = nullptr;
+    std::atomic<float>* analyzerAveraging = nullptr;
+    std::atomic<float>* analyzerHold = nullptr;
+    std::atomic<float>* analyzerOverlay = nullptr;
+    std::atomic<float>* analyzerView = nullptr;
+
+    //only these parameters change the response curve
+    juce::Array<int> filterParameterIndices;
+
     MonoChain monoChain;
 
     void updateChain();
 
-    juce::Image background; 
+    //the curve is only rebuilt when the filters, the size or the sample rate change
+    MagnitudeResponseEvaluator responseEvaluator;
+    std::vector<double> responseMagnitudes;
+    juce::Path responseCurve;
+    double responseSampleRate = 0.0;
+
+    void updateResponseCurve();
+
+    //static grid and labels, and the filter curve, each cached at the display scale
+    juce::Image background, curveLayer;
+    float layerScale = 0.f;
+
+    void drawBackgroundLayer(juce::Graphics& g);
+    void drawCurveLayer(juce::Graphics& g);
+    void drawSpectrum(juce::Graphics& g);
+    void drawHelp(juce::Graphics& g);
 
     juce::Rectangle<int> getRenderArea();
 
     juce::Rectangle<int> getAnalysisArea();
     
-    PathProducer leftPathProducer, rightPathProducer;
+    PathProducer analyzerPathProducer;
+    bool showingPrePost = false;
+    bool showingSpectrogram = false;
+
+    //subscribed after the path producer has drained the fifos, so the
+    //processor only starts feeding them once there's a clean reader
+    CaptureRegistry::Subscription analyzerSubscription;
 
     bool shouldShowFFTAnalysis = true;
     bool showHelp = false;
+
+    //shown over the analyser while the processor is saving CPU
+    Dsp::QualityTier shownQualityTier = Dsp::QualityTier::Full;
+    void drawQualityTier(juce::Graphics& g);
+
+    friend class Bench::EditorBenchmarks;
 };
 
 //==============================================================================
@@ -368,21 +1201,31 @@ struct SpectrumButton : juce::ToggleButton
 
 struct HelpButton : juce::ToggleButton {};
 
-class CourseworkPluginAudioProcessorEditor  : public juce::AudioProcessorEditor, public juce::Timer
+class CourseworkPluginAudioProcessorEditor  : public juce::AudioProcessorEditor, public Gui::FrameClock::Client
 {
 public:
     CourseworkPluginAudioProcessorEditor (CourseworkPluginAudioProcessor&);
     ~CourseworkPluginAudioProcessorEditor() override;
 
     //==============================================================================
-    void timerCallback() override;
+    bool frameTick() override;
     void paint (juce::Graphics&) override;
     void resized() override;
+
+   #if COURSEWORK_ENABLE_PROFILER
+    //P shows the profiler overlay, D dumps it to a file and R resets it
+    bool keyPressed(const juce::KeyPress& key) override;
+   #endif
 private:
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     juce::Image background;
 
+    //background image, labels and frames rendered once per size and display scale
+    juce::Image staticLayer;
+    float staticLayerScale = 0.f;
+    void drawStaticLayer(juce::Graphics& g);
+
     CourseworkPluginAudioProcessor& audioProcessor;
 
     //making the sliders
@@ -415,20 +1258,85 @@ private:
     SpectrumButton spectrumEnabledButton;
     HelpButton helpButton;
 
+    juce::ComboBox analyzerResolutionBox,
+        analyzerAveragingBox,
+        analyzerHoldBox,
+        analyzerOverlayBox,
+        analyzerViewBox;
+
     using ButtonAttachment = APVTS::ButtonAttachment;
     ButtonAttachment lowCutBypassButtonAttachment,
         highCutBypassButtonAttachment,
         spectrumEnabledButtonAttachment,
         helpButtonAttachment;
 
+    //combo box items have to exist before the attachment syncs to the parameter,
+    //so this one is made in the constructor body
+    using ComboBoxAttachment = APVTS::ComboBoxAttachment;
+    std::unique_ptr<ComboBoxAttachment> analyzerResolutionAttachment,
+        analyzerAveragingAttachment,
+        analyzerHoldAttachment,
+        analyzerOverlayAttachment,
+        analyzerViewAttachment;
+
+    void setupAnalyzerBox(juce::ComboBox& box,
+        std::unique_ptr<ComboBoxAttachment>& attachment,
+        Params::Id parameter,
+        const juce::String& tooltip);
+
     std::vector<juce::Component*> getComps();
 
     LookAndFeel lnf;
 
     Gui::VerticalMeter verticalMeterL, verticalMeterR;
 
+    //latest snapshot from the audio thread, smoothed here for the meters
+    Dsp::TelemetrySnapshot telemetry;
+    std::array<Gui::MeterBallistics, Dsp::TelemetrySnapshot::numChannels> meterBallistics;
+    double lastFrameTime = 0.0;
+
+    //the waveform and the goniometer share a panel, clicking it switches between them
+    Gui::WaveformView waveformView { audioProcessor.waveformCapture };
+    Gui::Goniometer goniometer { audioProcessor.stereoAnalyzer };
+    bool showingGoniometer = false;
+
+    void setShowingGoniometer(bool shouldShow);
+
+    Gui::LoudnessReadout loudnessReadout;
+
+    //the processor only captures what these are held for, the panel that's
+    //hidden gives its subscription up
+    CaptureRegistry::Subscription waveformSubscription, stereoSubscription, meterSubscription;
+
+   #if COURSEWORK_ENABLE_PROFILER
+    Gui::ProfilerOverlay profilerOverlay { audioProcessor.profiler };
+   #endif
+
+    //drives every visualiser in this editor, declared last so it stops before they go
+    Gui::FrameClock frameClock { *this };
+
+    friend class Bench::EditorBenchmarks;
+    friend class Bench::RegressionSuite;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CourseworkPluginAudioProcessorEditor)
 };
 
 void labelWriter(juce::Graphics& g, juce::Rectangle<int> area, juce::String text, int yPos);
 
+//renders into an image at the physical pixel size for the given display scale,
+//the drawer works in logical coordinates
+template<typename Drawer>
+juce::Image renderScaledLayer(int width, int height, float scale, Drawer&& draw)
+{
+    const auto imageWidth = juce::jmax(1, juce::roundToInt(width * scale));
+    const auto imageHeight = juce::jmax(1, juce::roundToInt(height * scale));
+
+    juce::Image layer(juce::Image::PixelFormat::ARGB, imageWidth, imageHeight, true);
+
+    juce::Graphics g(layer);
+    g.addTransform(juce::AffineTransform::scale(scale));
+    draw(g);
+
+    return layer;
+}
+
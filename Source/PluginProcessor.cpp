@@ -22,17 +22,40 @@ CourseworkPluginAudioProcessor::CourseworkPluginAudioProcessor()
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
-                       ), waveformViewer(2)
+                       )
 #endif
 {
-    //settings for the waveform visualiser
-    waveformViewer.setRepaintRate(60);
-    waveformViewer.setBufferSize(512);
-    waveformViewer.setSamplesPerBlock(8);
+    //the filters' coefficients are only ever overwritten in place after this
+    for (auto& chain : leftChains)
+        prepareCutFilterCoefficients(chain);
+
+    for (auto& chain : rightChains)
+        prepareCutFilterCoefficients(chain);
+
+    //the factory presets are decoded once, switching to one is a copy after that
+    for (size_t i = 0; i < presetConfigs.size(); ++i)
+    {
+        presetConfigs[i].values = Presets::getFactoryPresets()[i].values;
+
+        for (auto id : Presets::parameters)
+            presetConfigs[i].sets[static_cast<size_t>(id)] = true;
+
+        snapParameterValues(presetConfigs[i].values);
+        prepareProcessingConfig(presetConfigs[i], 0.0);
+    }
+
+    //undefined controllers, in the order of automatedParameters
+    int controller = firstAutomationController;
+    for (auto id : automatedParameters)
+        midiAutomation.addTarget(controller++, id, parameters.getParameter(id));
+
+    startTimerHz(10);
 }
 
 CourseworkPluginAudioProcessor::~CourseworkPluginAudioProcessor()
 {
+    //timerCallback() uses members that are about to go
+    stopTimer();
 }
 
 //==============================================================================
@@ -76,31 +99,51 @@ double CourseworkPluginAudioProcessor::getTailLengthSeconds() const
 
 int CourseworkPluginAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    return Presets::numPresets;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
+                                  // so this should be at least 1, even if you're not really implementing programs.
 }
 
 int CourseworkPluginAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram;
 }
 
 void CourseworkPluginAudioProcessor::setCurrentProgram (int index)
 {
+    if (!juce::isPositiveAndBelow(index, Presets::numPresets))
+        return;
+
+    currentProgram = index;
+
+    //designed once per sample rate, after that a switch is a copy and a crossfade, nothing is allocated
+    auto& preset = presetConfigs[static_cast<size_t>(index)];
+    if (preset.sampleRate != getSampleRate())
+        prepareProcessingConfig(preset, getSampleRate());
+
+    pendingConfigs.getWriteBuffer() = preset;
+    const auto generation = publishConfig();
+
+    writeParameterValues(preset);
+    restoresApplied.store(generation);
 }
 
 const juce::String CourseworkPluginAudioProcessor::getProgramName (int index)
 {
-    return {};
+    if (!juce::isPositiveAndBelow(index, Presets::numPresets))
+        return {};
+
+    return Presets::getFactoryPresets()[static_cast<size_t>(index)].name;
 }
 
 void CourseworkPluginAudioProcessor::changeProgramName (int index, const juce::String& newName)
 {
 }
 
-void CourseworkPluginAudioProcessor::updateLowCutFilters(const ChainSettings& chainSettings)
+void CourseworkPluginAudioProcessor::updateLowCutFilters(const ChainSettings& chainSettings, const Dsp::ButterworthSections& lowCutCoefficients)
 {
-    auto lowCutCoefficients = juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(chainSettings.lowCutFreq, getSampleRate(), 2 * (chainSettings.lowCutSlope + 1));
+    //the coefficients are copied into the filters in place, nothing is allocated
+    auto& leftChain = leftChains[activeChains];
+    auto& rightChain = rightChains[activeChains];
 
     //low cut filter in both channels
     auto& leftLowCut = leftChain.get <ChainPositions::LowCut>();
@@ -113,10 +156,11 @@ void CourseworkPluginAudioProcessor::updateLowCutFilters(const ChainSettings& ch
     updateFilter(rightLowCut, lowCutCoefficients, chainSettings.lowCutSlope);
 }
 
-void CourseworkPluginAudioProcessor::updateHighCutFilters(const ChainSettings& chainSettings)
+void CourseworkPluginAudioProcessor::updateHighCutFilters(const ChainSettings& chainSettings, const Dsp::ButterworthSections& highCutCoefficients)
 {
     //same with the high cut
-    auto highCutCoefficients = juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(chainSettings.highCutFreq, getSampleRate(), 2 * (chainSettings.highCutSlope + 1));
+    auto& leftChain = leftChains[activeChains];
+    auto& rightChain = rightChains[activeChains];
 
     auto& leftHighCut = leftChain.get <ChainPositions::HighCut>();
     auto& rightHighCut = rightChain.get <ChainPositions::HighCut>();
@@ -130,11 +174,88 @@ void CourseworkPluginAudioProcessor::updateHighCutFilters(const ChainSettings& c
 
 void CourseworkPluginAudioProcessor::updateFilters()
 {
-    auto chainSettings = getChainSettings(apvts);
+    updateFilters(getChainSettings(parameters));
+}
+
+void CourseworkPluginAudioProcessor::updateFilters(const ChainSettings& chainSettings)
+{
+    COURSEWORK_REALTIME_SCOPE("updateFilters");
+
+    //a host can restore state before the first prepareToPlay()
+    if (getSampleRate() <= 0.0)
+        return;
+
+    //designed into fixed arrays, then update both filters
+    Dsp::ButterworthSections lowCutCoefficients, highCutCoefficients;
+    designCutFilters(chainSettings, getSampleRate(), lowCutCoefficients, highCutCoefficients);
+
+    updateLowCutFilters(chainSettings, lowCutCoefficients);
+    updateHighCutFilters(chainSettings, highCutCoefficients);
+}
+
+juce::uint32 CourseworkPluginAudioProcessor::getFilterVersion() const
+{
+    return parameterSnapshot.getVersion({ Params::LowCutFreq, Params::HighCutFreq, Params::LowCutSlope,
+                                          Params::HighCutSlope, Params::LowCutBypassed, Params::HighCutBypassed });
+}
+
+void CourseworkPluginAudioProcessor::switchToConfig(ProcessingConfig& config)
+{
+    //a state restored before prepareToPlay() had no sample rate to design for
+    if (config.sampleRate != getSampleRate())
+        prepareProcessingConfig(config, getSampleRate());
+
+    //the first block after prepareToPlay() has nothing worth fading out
+    if (hasProcessedBlock && configFadeLength > 0)
+    {
+        //the outgoing filters keep ringing on their own, the incoming ones start from silence
+        activeChains = 1 - activeChains;
+        leftChains[activeChains].reset();
+        rightChains[activeChains].reset();
+
+        fadeShaperSettings = lastShaperSettings;
+        configFadeRemaining = configFadeLength;
+    }
+
+    updateLowCutFilters(config.chain, config.lowCut);
+    updateHighCutFilters(config.chain, config.highCut);
+    designedFilterVersion = getFilterVersion();
+}
+
+void CourseworkPluginAudioProcessor::applyShaper(juce::AudioBuffer<float>& buffer, int numChannels, int start, int end, const ShaperSettings& settings, bool fast)
+{
+    //get distortion parameters
+    const float drive = settings.drive;
+    const float postGain = settings.postGain;
+    const float mix = settings.mix;
+
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        float* channelData = buffer.getWritePointer(channel, start);
 
-    //update both filters
-    updateLowCutFilters(chainSettings);
-    updateHighCutFilters(chainSettings);
+        for (int sample = start; sample < end; sample++)
+        {
+            //save original signal
+            float drySignal = *channelData;
+
+            //raise volume
+            *channelData *= drive;
+
+            //clip audio with tanh function
+            //mix with original signal
+            //multiply by gain
+            float shaped = fast ? juce::dsp::FastMathApproximations::tanh(juce::jlimit(-5.f, 5.f, *channelData))
+                                : tanh(*channelData);
+            *channelData = ((shaped * mix + drySignal * (1 - mix))) * gainToAmplifier(postGain);
+
+            //other distortion algorithms
+            //*channelData = ((sin(*channelData) * mix + drySignal * (1 - mix))) * gainToAmplifier(postGain);
+            //*channelData = ((pow(sin(*channelData), 3) * mix + drySignal * (1 - mix))) * gainToAmplifier(postGain);
+            //*channelData = ( ( 0.625 * tan(sin(*channelData)) * mix + drySignal * (1 - mix) ) ) * gainToAmplifier(postGain);
+
+            channelData++;
+        }
+    }
 }
 
 //==============================================================================
@@ -150,19 +271,30 @@ void CourseworkPluginAudioProcessor::prepareToPlay (double sampleRate, int sampl
     spec.numChannels = 1;
     spec.sampleRate = sampleRate;
 
-    leftChain.prepare(spec);
-    rightChain.prepare(spec);
+    for (auto& chain : leftChains)
+        chain.prepare(spec);
+
+    for (auto& chain : rightChains)
+        chain.prepare(spec);
 
     updateFilters();
 
+    //room for the outgoing side of a crossfade
+    fadeBuffer.setSize(2, samplesPerBlock);
+    configFadeLength = juce::roundToInt(sampleRate * configFadeSeconds);
+    configFadeRemaining = 0;
+    hasProcessedBlock = false;
+
     leftChannelFifo.prepare(samplesPerBlock);
     rightChannelFifo.prepare(samplesPerBlock);
+    preChannelFifo.prepare(samplesPerBlock);
 
-    rmsLevelLeft.reset(sampleRate, 0.5);
-    rmsLevelRight.reset(sampleRate, 0.5);
+    loudnessMeter.prepare(sampleRate);
+    stereoAnalyzer.prepare(sampleRate, samplesPerBlock);
+    qualityGovernor.prepare(sampleRate);
 
-    rmsLevelLeft.setCurrentAndTargetValue(-100.f);
-    rmsLevelRight.setCurrentAndTargetValue(-100.f);
+    //every subscribed stream is reset again on the first block
+    captureActive.fill(false);
 
     //sine oscillator tester
     //osc.initialise([](float x) { return std::sin(x); });
@@ -207,6 +339,53 @@ bool CourseworkPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout&
 void CourseworkPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    COURSEWORK_REALTIME_SCOPE("processBlock");
+
+    const auto blockStart = juce::Time::getHighResolutionTicks();
+
+    const auto numSamples = buffer.getNumSamples();
+
+    //parameter values at the start of the block
+    parameterSnapshot.update(parameters);
+
+    //a restored state or preset arrives in one piece, see setStateInformation(). its values stand in
+    //for the parameters until every restore published so far has finished writing them, so no block
+    //sees half of one. restoresPublished is read after the parameters: if the snapshot caught any of
+    //a restore's writes, this sees that restore, and the read below gets its config or a newer one
+    const auto published = restoresPublished.load();
+
+    if (pendingConfigs.read(restoredConfig))
+    {
+        holdingRestoredValues = true;
+        configSwitchPending = true;
+    }
+
+    if (holdingRestoredValues)
+    {
+        if (restoresApplied.load() >= published)
+            holdingRestoredValues = false;
+        else
+            for (size_t i = 0; i < restoredConfig.values.size(); ++i)
+                if (restoredConfig.sets[i])
+                    parameterSnapshot.set(static_cast<Params::Id>(i), restoredConfig.values[i]);
+    }
+
+    //one that arrives during a crossfade is held straight away, but only switched to once the fade is over
+    if (configSwitchPending && configFadeRemaining == 0)
+    {
+        configSwitchPending = false;
+        switchToConfig(restoredConfig);
+    }
+
+    //overridden by CCs the parameters haven't caught up with, and the CCs that change them part way through
+    midiAutomation.beginBlock(midiMessages, numSamples, parameterSnapshot);
+
+    //Auto is the first choice, the rest pin a tier. offline renders have no deadline,
+    //so they stay at full quality unless a tier is pinned
+    const int qualityMode = parameterSnapshot.get<Params::QualityMode>();
+    qualityGovernor.setForcedTier(qualityMode - 1);
+    const auto qualityTier = isNonRealtime() && qualityMode == 0 ? Dsp::QualityTier::Full : qualityGovernor.getTier();
+
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -219,83 +398,212 @@ void CourseworkPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buf
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    //update filters
-    updateFilters();
+    auto chainSettings = getChainSettings(parameterSnapshot);
+    auto shaperSettings = getShaperSettings(parameterSnapshot);
 
-    juce::dsp::AudioBlock<float> block(buffer);
+    //the old state runs on a copy of the input while it fades out. a block bigger than
+    //prepareToPlay() promised has no room for it, so the fade is cut short
+    if (configFadeRemaining > 0 && numSamples > fadeBuffer.getNumSamples())
+        configFadeRemaining = 0;
 
-    //sine oscillator
-    //buffer.clear();
-    //
-    //juce::dsp::ProcessContextReplacing<float> stereoContext(block);
-    //osc.process(stereoContext);
+    const bool fading = configFadeRemaining > 0;
+    const int numFadeChannels = juce::jmin(totalNumInputChannels, fadeBuffer.getNumChannels());
 
-    auto leftBlock = block.getSingleChannelBlock(0);
-    auto rightBlock = block.getSingleChannelBlock(1);
+    if (fading)
+        for (int channel = 0; channel < numFadeChannels; ++channel)
+            fadeBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
 
-    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-    juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+    COURSEWORK_PROFILE_BEGIN_BLOCK(profiler);
 
-    leftChain.process(leftContext);
-    rightChain.process(rightContext);
+    {
+        COURSEWORK_PROFILE_STAGE(profiler, Filters);
 
-    //get distortion parameters
-    float drive = *apvts.getRawParameterValue("Drive");
-    float postGain = *apvts.getRawParameterValue("Post Gain");
-    float mix = *apvts.getRawParameterValue("Mix");
+        //update filters, only when one of their parameters has moved since they were last designed
+        const auto filterVersion = getFilterVersion();
+        if (filterVersion != designedFilterVersion)
+        {
+            updateFilters(chainSettings);
+            designedFilterVersion = filterVersion;
+        }
 
-    //distortion logic
-    for (int channel = 0; channel < totalNumInputChannels; channel++)
-    {
-        float* channelData = buffer.getWritePointer(channel);
-        
-        for (int sample = 0; sample < buffer.getNumSamples(); sample++)
+        juce::dsp::AudioBlock<float> block(buffer);
+
+        //sine oscillator
+        //buffer.clear();
+        //
+        //juce::dsp::ProcessContextReplacing<float> stereoContext(block);
+        //osc.process(stereoContext);
+
+        //filters up to the end sample, from where the last segment stopped
+        int segmentStart = 0;
+        auto processFilters = [&](int segmentEnd)
         {
-            //save original signal
-            float drySignal = *channelData;
+            if (segmentEnd <= segmentStart)
+                return;
 
-            //raise volume
-            *channelData *= drive;
+            auto segment = block.getSubBlock((size_t)segmentStart, (size_t)(segmentEnd - segmentStart));
+            auto leftBlock = segment.getSingleChannelBlock(0);
+            auto rightBlock = segment.getSingleChannelBlock(1);
 
-            //clip audio with tanh function
-            //mix with original signal
-            //multiply by gain
-            *channelData = ((tanh(*channelData) * mix + drySignal * (1 - mix))) * gainToAmplifier(postGain);
+            juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
+            juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
 
-            //other distortion algorithms
-            //*channelData = ((sin(*channelData) * mix + drySignal * (1 - mix))) * gainToAmplifier(postGain);
-            //*channelData = ((pow(sin(*channelData), 3) * mix + drySignal * (1 - mix))) * gainToAmplifier(postGain);
-            //*channelData = ( ( 0.625 * tan(sin(*channelData)) * mix + drySignal * (1 - mix) ) ) * gainToAmplifier(postGain);
+            leftChains[activeChains].process(leftContext);
+            rightChains[activeChains].process(rightContext);
 
-            channelData++;
+            segmentStart = segmentEnd;
+        };
+
+        //a CC that moves a filter splits the block there, the redesign is in place so short segments stay cheap.
+        //CCs on the same sample are applied together
+        for (int i = 0; i < midiAutomation.getNumEvents();)
+        {
+            const auto time = midiAutomation.getEvent(i).sample;
+            auto changed = chainSettings;
+            bool filtersChanged = false;
+
+            for (; i < midiAutomation.getNumEvents() && midiAutomation.getEvent(i).sample == time; ++i)
+                filtersChanged = applyAutomation(changed, midiAutomation.getEvent(i)) || filtersChanged;
+
+            if (filtersChanged)
+            {
+                processFilters(time);
+
+                chainSettings = changed;
+                updateFilters(chainSettings);
+            }
+        }
+
+        processFilters(numSamples);
+
+        if (fading)
+        {
+            juce::dsp::AudioBlock<float> fadeBlock(fadeBuffer);
+            auto leftBlock = fadeBlock.getSubBlock(0, (size_t)numSamples).getSingleChannelBlock(0);
+            auto rightBlock = fadeBlock.getSubBlock(0, (size_t)numSamples).getSingleChannelBlock(1);
+
+            juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
+            juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+
+            leftChains[1 - activeChains].process(leftContext);
+            rightChains[1 - activeChains].process(rightContext);
         }
     }
 
-    //waveform viewer
-    waveformViewer.pushBuffer(buffer);
+    //the analyser is only fed when an editor is open and the spectrum is switched on
+    const bool spectrumEnabled = parameterSnapshot.get<Params::SpectrumEnabled>();
+    const bool captureAnalyzer = updateCaptureState(CaptureStream::Analyzer, spectrumEnabled && qualityTier < Dsp::QualityTier::Reduced);
+    const bool captureWaveform = updateCaptureState(CaptureStream::Waveform, true);
+    const bool captureMeters = updateCaptureState(CaptureStream::Meters, true);
+    const bool captureStereo = updateCaptureState(CaptureStream::Stereo, true);
+
+    //capture the filtered signal before it's distorted
+    if (captureAnalyzer)
+    {
+        COURSEWORK_PROFILE_STAGE(profiler, Capture);
+        preChannelFifo.update(buffer);
+    }
+
+    //levels going into the distortion, for the drive and gain reduction readings
+    ChannelLevels inputPeaks{}, inputRms{};
+    if (captureMeters)
+    {
+        COURSEWORK_PROFILE_STAGE(profiler, Metering);
 
-    //update FFT spectrum analyser
-    leftChannelFifo.update(buffer);
-    rightChannelFifo.update(buffer);
+        for (int channel = 0; channel < juce::jmin(totalNumInputChannels, Dsp::TelemetrySnapshot::numChannels); ++channel)
+        {
+            inputPeaks[channel] = buffer.getMagnitude(channel, 0, buffer.getNumSamples());
+            inputRms[channel] = buffer.getRMSLevel(channel, 0, buffer.getNumSamples());
+        }
+    }
 
-    //level meter
+    //distortion logic
+    {
+        COURSEWORK_PROFILE_STAGE(profiler, Waveshaper);
+
+        //the Pade approximation is only accurate to +-5, tanh is flat past there anyway
+        const bool fastShaper = qualityTier >= Dsp::QualityTier::Economy;
+
+        //distorts up to the end sample with the current settings, from where the last segment stopped
+        int segmentStart = 0;
+        auto processShaper = [&](int segmentEnd)
+        {
+            applyShaper(buffer, totalNumInputChannels, segmentStart, segmentEnd, shaperSettings, fastShaper);
+            segmentStart = segmentEnd;
+        };
+
+        //everything before a CC is distorted with the settings from before it
+        for (int i = 0; i < midiAutomation.getNumEvents(); ++i)
+        {
+            const auto& event = midiAutomation.getEvent(i);
+            auto changed = shaperSettings;
+
+            if (applyAutomation(changed, event))
+            {
+                processShaper(event.sample);
+                shaperSettings = changed;
+            }
+        }
+
+        processShaper(numSamples);
+        lastShaperSettings = shaperSettings;
+
+        //linear crossfade from the old state's output, carried on from the last block
+        if (fading)
+        {
+            applyShaper(fadeBuffer, numFadeChannels, 0, numSamples, fadeShaperSettings, fastShaper);
+
+            const auto fadePosition = configFadeLength - configFadeRemaining;
+            for (int channel = 0; channel < numFadeChannels; ++channel)
+            {
+                auto* data = buffer.getWritePointer(channel);
+                const auto* fadeData = fadeBuffer.getReadPointer(channel);
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const auto gain = juce::jmin(1.f, static_cast<float>(fadePosition + i) / static_cast<float>(configFadeLength));
+                    data[i] = fadeData[i] + gain * (data[i] - fadeData[i]);
+                }
+            }
+
+            configFadeRemaining = juce::jmax(0, configFadeRemaining - numSamples);
+        }
+    }
 
-    rmsLevelLeft.skip(buffer.getNumSamples());
-    rmsLevelRight.skip(buffer.getNumSamples());
     {
-        const auto value = juce::Decibels::gainToDecibels(buffer.getRMSLevel(0, 0, buffer.getNumSamples()));
-        if (value < rmsLevelLeft.getCurrentValue())
-            rmsLevelLeft.setTargetValue(value);
-        else
-            rmsLevelLeft.setCurrentAndTargetValue(value);
+        COURSEWORK_PROFILE_STAGE(profiler, Capture);
+
+        //waveform viewer
+        if (captureWaveform)
+            waveformCapture.push(buffer);
+
+        //goniometer and correlation
+        if (captureStereo)
+            stereoAnalyzer.process(buffer);
+
+        //update FFT spectrum analyser
+        if (captureAnalyzer)
+        {
+            leftChannelFifo.update(buffer);
+            rightChannelFifo.update(buffer);
+        }
     }
+
+    //level meter
+    if (captureMeters)
     {
-        const auto value = juce::Decibels::gainToDecibels(buffer.getRMSLevel(1, 0, buffer.getNumSamples()));
-        if (value < rmsLevelRight.getCurrentValue())
-            rmsLevelRight.setTargetValue(value);
-        else
-            rmsLevelRight.setCurrentAndTargetValue(value);
+        COURSEWORK_PROFILE_STAGE(profiler, Metering);
+
+        loudnessMeter.process(buffer, qualityTier < Dsp::QualityTier::Minimal);
+        publishTelemetry(buffer, shaperSettings.drive, inputPeaks, inputRms);
     }
+
+    COURSEWORK_PROFILE_END_BLOCK(profiler, buffer.getNumSamples(), getSampleRate());
+
+    hasProcessedBlock = true;
+
+    if (!isNonRealtime())
+        qualityGovernor.addBlock(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - blockStart), buffer.getNumSamples());
 }
 
 float gainToAmplifier(float gain)
@@ -326,9 +634,14 @@ void CourseworkPluginAudioProcessor::getStateInformation (juce::MemoryBlock& des
     // as intermediaries to make it easy to save and load complex data.
 
 
-    //saving the parameter states
-    juce::MemoryOutputStream mos(destData, true);
-    apvts.state.writeToStream(mos);
+    //saving the parameter states, every plain value in the binary format. ones that aren't
+    //saved keep their slot with the default, so the indices stay the same
+    StateFormat::Values values;
+    for (const auto& info : Params::table)
+        values[static_cast<size_t>(info.index)] = Params::isSaved(info.index) ? parameters.getRawValue(info.index).load()
+                                                                               : info.defaultValue;
+
+    StateFormat::write(values, destData);
 }
 
 void CourseworkPluginAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
@@ -336,83 +649,285 @@ void CourseworkPluginAudioProcessor::setStateInformation (const void* data, int
     // You should use this method to restore your parameters from this memory block,
     // whose contents will have been created by the getStateInformation() call.
 
-    //loading parameter states
-    auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
-    if (tree.isValid())
+    //loading parameter states. the binary format is read straight into the values, states saved
+    //before it are ValueTrees. either way only the saved parameters are written back
+    auto& config = pendingConfigs.getWriteBuffer();
+    for (const auto& info : Params::table)
+        config.sets[static_cast<size_t>(info.index)] = Params::isSaved(info.index);
+
+    if (!StateFormat::read(data, sizeInBytes, config.values))
+    {
+        const auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
+        if (!tree.isValid())
+            return;
+
+        readParameterValues(tree, config.values);
+    }
+
+    //the audio thread gets the whole state at once with its filters already designed, instead of
+    //picking the parameters up one at a time while they're written. it never touches
+    //the filters from here, processBlock switches to the new ones itself
+    snapParameterValues(config.values);
+    prepareProcessingConfig(config, getSampleRate());
+
+    //the config belongs to the audio thread once it's published
+    const auto restored = config;
+    const auto generation = publishConfig();
+
+    writeParameterValues(restored);
+
+    restoresApplied.store(generation);
+
+    //a session is its own sound, not any of the presets
+    currentProgram = 0;
+}
+
+juce::uint32 CourseworkPluginAudioProcessor::publishConfig()
+{
+    //the config is published before its number, and its number before any of its parameters are written
+    const auto generation = restoresPublished.load() + 1;
+    pendingConfigs.getWriteBuffer().generation = generation;
+    pendingConfigs.publish();
+    restoresPublished.store(generation);
+
+    return generation;
+}
+
+void CourseworkPluginAudioProcessor::readParameterValues(const juce::ValueTree& state, std::array<float, Params::NumParameters>& values) const
+{
+    //missing ones at their default, the same as replaceState() would leave them
+    for (const auto& info : Params::table)
+        values[static_cast<size_t>(info.index)] = static_cast<float>(state.getChildWithProperty("id", info.id).getProperty("value", info.defaultValue));
+}
+
+void CourseworkPluginAudioProcessor::snapParameterValues(std::array<float, Params::NumParameters>& values) const
+{
+    //into range and onto the interval, as the parameters will store them
+    for (const auto& info : Params::table)
+    {
+        auto& parameter = parameters.getParameter(info.index);
+        auto& value = values[static_cast<size_t>(info.index)];
+
+        value = parameter.convertFrom0to1(parameter.convertTo0to1(value));
+    }
+}
+
+void CourseworkPluginAudioProcessor::writeParameterValues(const ProcessingConfig& config)
+{
+    for (const auto& info : Params::table)
     {
-        apvts.replaceState(tree);
-        updateFilters();
+        if (!config.sets[static_cast<size_t>(info.index)])
+            continue;
+
+        auto& parameter = parameters.getParameter(info.index);
+        const auto normalised = parameter.convertTo0to1(config.values[static_cast<size_t>(info.index)]);
+
+        if (parameter.getValue() != normalised)
+            parameter.setValueNotifyingHost(normalised);
     }
 }
 
-float CourseworkPluginAudioProcessor::getRmsValue(const int channel) const
+bool CourseworkPluginAudioProcessor::applyAutomation(ChainSettings& settings, const Dsp::MidiAutomation::Event& event)
 {
-    jassert(channel == 0 || channel == 1);
-    if (channel == 0)
-        return rmsLevelLeft.getCurrentValue();
-    if (channel == 1)
-        return rmsLevelRight.getCurrentValue();
-    return 0.f;
+    switch (event.target)
+    {
+        case Params::LowCutFreq:        settings.lowCutFreq = event.value; return true;
+        case Params::HighCutFreq:       settings.highCutFreq = event.value; return true;
+        case Params::LowCutSlope:       settings.lowCutSlope = static_cast<Slope>(juce::roundToInt(event.value)); return true;
+        case Params::HighCutSlope:      settings.highCutSlope = static_cast<Slope>(juce::roundToInt(event.value)); return true;
+        case Params::LowCutBypassed:    settings.lowCutBypassed = event.value > 0.5f; return true;
+        case Params::HighCutBypassed:   settings.highCutBypassed = event.value > 0.5f; return true;
+        default:                        return false;
+    }
 }
 
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts)
+bool CourseworkPluginAudioProcessor::applyAutomation(ShaperSettings& settings, const Dsp::MidiAutomation::Event& event)
+{
+    switch (event.target)
+    {
+        case Params::Drive:     settings.drive = event.value; return true;
+        case Params::PostGain:  settings.postGain = event.value; return true;
+        case Params::Mix:       settings.mix = event.value; return true;
+        default:                return false;
+    }
+}
+
+void CourseworkPluginAudioProcessor::timerCallback()
+{
+    midiAutomation.applyToParameters();
+
+    //the host only hears about the tier from the message thread
+    auto& tierParameter = parameters.getParameter(Params::QualityTier);
+    const auto tier = static_cast<float>(qualityGovernor.getTier());
+
+    if (tierParameter.convertFrom0to1(tierParameter.getValue()) != tier)
+        tierParameter.setValueNotifyingHost(tierParameter.convertTo0to1(tier));
+}
+
+bool CourseworkPluginAudioProcessor::updateCaptureState(CaptureStream stream, bool enabled)
+{
+    //a stream is fed while something reads it, and is reset on the block it starts again
+    const auto active = enabled && captureRegistry.isSubscribed(stream);
+    auto& wasActive = captureActive[static_cast<size_t>(stream)];
+
+    if (active && !wasActive)
+        restartCapture(stream);
+
+    wasActive = active;
+    return active;
+}
+
+void CourseworkPluginAudioProcessor::restartCapture(CaptureStream stream)
+{
+    //whatever was half captured before the stream stopped is stale
+    switch (stream)
+    {
+        case CaptureStream::Analyzer:
+            leftChannelFifo.discardPartialBlock();
+            rightChannelFifo.discardPartialBlock();
+            preChannelFifo.discardPartialBlock();
+            break;
+        case CaptureStream::Waveform:
+            waveformCapture.reset();
+            break;
+        case CaptureStream::Meters:
+            clipCounts.fill(0);
+            overCounts.fill(0);
+            fullScaleRuns.fill(0);
+            telemetryBlocks = 0;
+            loudnessMeter.restart();
+            break;
+        case CaptureStream::Stereo:
+            stereoAnalyzer.restart();
+            break;
+        default:
+            break;
+    }
+}
+
+void CourseworkPluginAudioProcessor::publishTelemetry(const juce::AudioBuffer<float>& buffer, float drive, const ChannelLevels& inputPeaks, const ChannelLevels& inputRms)
+{
+    using Decibels = juce::Decibels;
+
+    auto& snapshot = telemetry.getWriteBuffer();
+    const auto numSamples = buffer.getNumSamples();
+
+    for (int channel = 0; channel < Dsp::TelemetrySnapshot::numChannels; ++channel)
+    {
+        auto& out = snapshot.channels[channel];
+
+        if (channel >= buffer.getNumChannels())
+        {
+            out = {};
+            continue;
+        }
+
+        //count samples at full scale, and every third one in a row as an over
+        const auto* data = buffer.getReadPointer(channel);
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (std::abs(data[i]) >= 1.f)
+            {
+                ++clipCounts[channel];
+                if (++fullScaleRuns[channel] == 3)
+                    ++overCounts[channel];
+            }
+            else
+            {
+                fullScaleRuns[channel] = 0;
+            }
+        }
+
+        const auto peak = buffer.getMagnitude(channel, 0, numSamples);
+        const auto rms = buffer.getRMSLevel(channel, 0, numSamples);
+
+        out.peak = Decibels::gainToDecibels(peak, -100.f);
+        out.rms = Decibels::gainToDecibels(rms, -100.f);
+        out.clipCount = clipCounts[channel];
+        out.overCount = overCounts[channel];
+
+        //tanh is monotonic, so the clipped peak is the tanh of the driven peak
+        const auto drivenPeak = inputPeaks[channel] * drive;
+        out.driveReduction = drivenPeak > 0.f
+            ? Decibels::gainToDecibels(drivenPeak) - Decibels::gainToDecibels(std::tanh(drivenPeak))
+            : 0.f;
+
+        out.gainReduction = inputRms[channel] > 0.f && rms > 0.f
+            ? Decibels::gainToDecibels(inputRms[channel]) - Decibels::gainToDecibels(rms)
+            : 0.f;
+    }
+
+    snapshot.blockCount = ++telemetryBlocks;
+    snapshot.sampleRate = getSampleRate();
+
+    telemetry.publish();
+}
+
+ChainSettings getChainSettings(const Params::Handles& handles)
 {
     ChainSettings settings;
 
-    //get parameter values
-    settings.lowCutFreq = apvts.getRawParameterValue("LowCut Freq")->load();
-    settings.highCutFreq = apvts.getRawParameterValue("HighCut Freq")->load();
-    settings.lowCutSlope = static_cast<Slope>(apvts.getRawParameterValue("LowCut Slope")->load());
-    settings.highCutSlope = static_cast<Slope>(apvts.getRawParameterValue("HighCut Slope")->load());
+    //get parameter values, through the handles so nothing is looked up by ID
+    settings.lowCutFreq = handles.getRawValue(Params::LowCutFreq).load();
+    settings.highCutFreq = handles.getRawValue(Params::HighCutFreq).load();
+    settings.lowCutSlope = static_cast<Slope>(handles.getRawValue(Params::LowCutSlope).load());
+    settings.highCutSlope = static_cast<Slope>(handles.getRawValue(Params::HighCutSlope).load());
     
-    settings.lowCutBypassed = apvts.getRawParameterValue("LowCut Bypassed")->load() > 0.5f;
-    settings.highCutBypassed = apvts.getRawParameterValue("HighCut Bypassed")->load() > 0.5f;
+    settings.lowCutBypassed = handles.getRawValue(Params::LowCutBypassed).load() > 0.5f;
+    settings.highCutBypassed = handles.getRawValue(Params::HighCutBypassed).load() > 0.5f;
 
     return settings;
 }
 
-void updateCoefficients(Coefficients& old, const Coefficients& replacements)
+ChainSettings getChainSettings(const Params::Snapshot& snapshot)
 {
-    *old = *replacements;
+    ChainSettings settings;
+
+    settings.lowCutFreq = snapshot.get<Params::LowCutFreq>();
+    settings.highCutFreq = snapshot.get<Params::HighCutFreq>();
+    settings.lowCutSlope = static_cast<Slope>(snapshot.get<Params::LowCutSlope>());
+    settings.highCutSlope = static_cast<Slope>(snapshot.get<Params::HighCutSlope>());
+
+    settings.lowCutBypassed = snapshot.get<Params::LowCutBypassed>();
+    settings.highCutBypassed = snapshot.get<Params::HighCutBypassed>();
+
+    return settings;
 }
 
-juce::AudioProcessorValueTreeState::ParameterLayout CourseworkPluginAudioProcessor::createParameterLayout()
+ShaperSettings getShaperSettings(const Params::Snapshot& snapshot)
 {
-    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+    ShaperSettings settings;
 
-    //making variables for the filter frequencies
-    //normalisableRange -> (lower frequency, upper frequency, frequency step, skew)
-    layout.add(std::make_unique<juce::AudioParameterFloat>("LowCut Freq", "LowCut Freq", juce::NormalisableRange<float>(10.f, 20000.f, 1.f, 0.25f), 10.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("HighCut Freq", "HighCut Freq", juce::NormalisableRange<float>(10.f, 20000.f, 1.f, 0.25f), 20000.f));
+    settings.drive = snapshot.get<Params::Drive>();
+    settings.postGain = snapshot.get<Params::PostGain>();
+    settings.mix = snapshot.get<Params::Mix>();
 
-    //making different slopes: 12db/Oct, 24db/Oct, 36db/Oct and 48db/Oct
-    juce::StringArray stringArray;
-    for (int i = 0; i < 4; ++i)
-    {
-        juce::String str;
-        str << (12 + i * 12);
-        str << " db/Oct";
-        stringArray.add(str);
-    }
+    return settings;
+}
 
-    //slopes for the filters
-    layout.add(std::make_unique<juce::AudioParameterChoice>("LowCut Slope", "LowCut Slope", stringArray, 0));
-    layout.add(std::make_unique<juce::AudioParameterChoice>("HighCut Slope", "HighCut Slope", stringArray, 0));
+void prepareProcessingConfig(ProcessingConfig& config, double sampleRate)
+{
+    Params::Snapshot snapshot;
+    for (size_t i = 0; i < config.values.size(); ++i)
+        snapshot.set(static_cast<Params::Id>(i), config.values[i]);
 
-    //parameters for distortion
-    layout.add(std::make_unique<juce::AudioParameterFloat>("Drive", "Drive", juce::NormalisableRange<float>(1.f, 10.f, 0.01f, 1.f), 1.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("Post Gain", "Post Gain", juce::NormalisableRange<float>(-12.f, 0.f, 0.01f, 1.f), 0.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("Mix", "Mix", juce::NormalisableRange<float>(0.f, 1.f, 0.01f, 1.f), 1.f));
+    config.chain = getChainSettings(snapshot);
+    config.shaper = getShaperSettings(snapshot);
+    config.sampleRate = sampleRate;
 
-    //toggle box for bypass buttons
-    layout.add(std::make_unique<juce::AudioParameterBool>("LowCut Bypassed", "LowCut Bypassed", false));
-    layout.add(std::make_unique<juce::AudioParameterBool>("HighCut Bypassed", "HighCut Bypassed", false));
-    layout.add(std::make_unique<juce::AudioParameterBool>("Spectrum Enabled", "Spectrum Enabled", true));
+    if (sampleRate > 0.0)
+        designCutFilters(config.chain, sampleRate, config.lowCut, config.highCut);
+}
 
-    //toggle box for help menu
-    layout.add(std::make_unique<juce::AudioParameterBool>("Help Button", "Help Button", false));
+void updateCoefficients(Coefficients& old, const Coefficients& replacements)
+{
+    *old = *replacements;
+}
 
-    return layout;
+juce::AudioProcessorValueTreeState::ParameterLayout CourseworkPluginAudioProcessor::createParameterLayout()
+{
+    //the IDs, ranges and defaults are all in Params::table
+    return Params::createLayout();
 }
 
 //==============================================================================
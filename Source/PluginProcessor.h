@@ -10,6 +10,19 @@
 
 #include <JuceHeader.h>
 
+#include "Parameters.h"
+#include "StateFormat.h"
+#include "Presets.h"
+#include "DSP/WaveformCapture.h"
+#include "DSP/LoudnessMeter.h"
+#include "DSP/Telemetry.h"
+#include "DSP/StereoAnalyzer.h"
+#include "DSP/Profiler.h"
+#include "DSP/Butterworth.h"
+#include "DSP/RealtimeGuard.h"
+#include "DSP/QualityGovernor.h"
+#include "DSP/MidiAutomation.h"
+
 #include <array>
 template<typename T>
 struct Fifo
@@ -116,6 +129,8 @@ struct SingleChannelSampleFifo
     }
     //==============================================================================
     int getNumCompleteBuffersAvailable() const { return audioBufferFifo.getNumAvailableForReading(); }
+    //audio thread only, drops a half filled block so capture restarts on a clean boundary
+    void discardPartialBlock() { fifoIndex = 0; }
     bool isPrepared() const { return prepared.get(); }
     int getSize() const { return size.get(); }
     //==============================================================================
@@ -144,6 +159,68 @@ private:
     }
 };
 
+//the visualisation streams the audio thread can capture
+enum class CaptureStream
+{
+    Analyzer,
+    Waveform,
+    Meters,
+    Stereo,
+    NumStreams
+};
+
+//counts the readers of each capture stream. the audio thread only feeds a stream
+//while it has at least one subscriber, so nothing is captured without an editor
+class CaptureRegistry
+{
+public:
+    //holds one subscription until it's destroyed or released
+    class Subscription
+    {
+    public:
+        Subscription() = default;
+        Subscription(CaptureRegistry& r, CaptureStream s) : registry(&r), stream(s)
+        {
+            registry->counts[static_cast<size_t>(stream)].fetch_add(1, std::memory_order_release);
+        }
+        ~Subscription() { release(); }
+
+        Subscription(Subscription&& other) noexcept : registry(std::exchange(other.registry, nullptr)), stream(other.stream) {}
+        Subscription& operator=(Subscription&& other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                registry = std::exchange(other.registry, nullptr);
+                stream = other.stream;
+            }
+            return *this;
+        }
+
+        void release()
+        {
+            if (registry != nullptr)
+                registry->counts[static_cast<size_t>(stream)].fetch_sub(1, std::memory_order_release);
+
+            registry = nullptr;
+        }
+    private:
+        CaptureRegistry* registry = nullptr;
+        CaptureStream stream = CaptureStream::Analyzer;
+
+        JUCE_DECLARE_NON_COPYABLE(Subscription)
+    };
+
+    Subscription subscribe(CaptureStream stream) { return { *this, stream }; }
+
+    bool isSubscribed(CaptureStream stream) const
+    {
+        return counts[static_cast<size_t>(stream)].load(std::memory_order_acquire) > 0;
+    }
+private:
+    std::array<std::atomic<int>, static_cast<size_t>(CaptureStream::NumStreams)> counts{};
+};
+
 enum Slope
 {
     Slope_12,
@@ -161,7 +238,24 @@ struct ChainSettings
     bool lowCutBypassed{ false }, highCutBypassed{ false };
 };
 
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts);
+ChainSettings getChainSettings(const Params::Handles& handles);
+ChainSettings getChainSettings(const Params::Snapshot& snapshot);
+
+//the parameters MIDI CCs automate, from CC 20 upwards in this order
+constexpr int firstAutomationController = 20;
+inline constexpr std::array<Params::Id, 9> automatedParameters
+{
+    Params::LowCutFreq, Params::HighCutFreq, Params::LowCutSlope, Params::HighCutSlope,
+    Params::LowCutBypassed, Params::HighCutBypassed, Params::Drive, Params::PostGain, Params::Mix
+};
+
+//the distortion's settings for one stretch of a block
+struct ShaperSettings
+{
+    float drive{ 1.f }, postGain{ 0.f }, mix{ 1.f };
+};
+
+ShaperSettings getShaperSettings(const Params::Snapshot& snapshot);
 
 using Filter = juce::dsp::IIR::Filter<float>;
 
@@ -179,6 +273,14 @@ enum ChainPositions
 using Coefficients = Filter::CoefficientsPtr;
 void updateCoefficients(Coefficients& old, const Coefficients& replacements);
 
+//allocation free, writes a biquad into the filter's own coefficients,
+//which prepareCutFilterCoefficients() has made second order
+inline void updateCoefficients(Coefficients& old, const Dsp::BiquadCoefficients& replacement)
+{
+    jassert(old->coefficients.size() == static_cast<int>(replacement.size()));
+    std::copy(replacement.begin(), replacement.end(), old->getRawCoefficients());
+}
+
 //the different slopes have different strengths of the slopes so we get the different strengths
 //for example, the 12db/Oct filter has one 12db/Oct filter while the 24db/Oct filter has two 12 db/Oct filters
 
@@ -221,6 +323,51 @@ void updateFilter(ChainType& chain, const CoefficientType& coefficients, const S
     }
 }
 
+//gives every cut filter its own second order coefficients, so they can be updated in place.
+//allocates, the processor does this once in its constructor
+inline void prepareCutFilterCoefficients(MonoChain& chain)
+{
+    auto prepare = [](CutFilter& cut)
+    {
+        cut.get<0>().coefficients = new Filter::Coefficients(1.f, 0.f, 0.f, 1.f, 0.f, 0.f);
+        cut.get<1>().coefficients = new Filter::Coefficients(1.f, 0.f, 0.f, 1.f, 0.f, 0.f);
+        cut.get<2>().coefficients = new Filter::Coefficients(1.f, 0.f, 0.f, 1.f, 0.f, 0.f);
+        cut.get<3>().coefficients = new Filter::Coefficients(1.f, 0.f, 0.f, 1.f, 0.f, 0.f);
+    };
+
+    prepare(chain.get<ChainPositions::LowCut>());
+    prepare(chain.get<ChainPositions::HighCut>());
+}
+
+//both cut filters' sections for the settings, allocation free
+inline void designCutFilters(const ChainSettings& chainSettings, double sampleRate, Dsp::ButterworthSections& lowCut, Dsp::ButterworthSections& highCut)
+{
+    Dsp::Butterworth::designHighPass(chainSettings.lowCutFreq, sampleRate, 2 * (chainSettings.lowCutSlope + 1), lowCut);
+    Dsp::Butterworth::designLowPass(chainSettings.highCutFreq, sampleRate, 2 * (chainSettings.highCutSlope + 1), highCut);
+}
+
+//every parameter of a restored state, with the filters already designed for it. built off the
+//audio thread, so processBlock can switch to it in one go
+struct ProcessingConfig
+{
+    //plain values, by Params::Id, and which of them it sets. the others keep the parameters' own values
+    std::array<float, Params::NumParameters> values{};
+    std::array<bool, Params::NumParameters> sets{};
+
+    ChainSettings chain;
+    ShaperSettings shaper;
+    Dsp::ButterworthSections lowCut, highCut;
+
+    //the rate the filters were designed for, 0 if they weren't
+    double sampleRate = 0.0;
+
+    //which restore this was, see CourseworkPluginAudioProcessor::setStateInformation()
+    juce::uint32 generation = 0;
+};
+
+//fills in the settings from the values, and designs the filters if the sample rate is known
+void prepareProcessingConfig(ProcessingConfig& config, double sampleRate);
+
 inline auto makeLowCutFilter(const ChainSettings& chainSettings, double sampleRate)
 {
     return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(chainSettings.lowCutFreq, sampleRate, 2 * (chainSettings.lowCutSlope + 1));
@@ -233,7 +380,8 @@ inline auto makeHighCutFilter(const ChainSettings& chainSettings, double sampleR
 
 //==============================================================================
 
-class CourseworkPluginAudioProcessor  : public juce::AudioProcessor
+class CourseworkPluginAudioProcessor  : public juce::AudioProcessor,
+                                        private juce::Timer
                             #if JucePlugin_Enable_ARA
                              , public juce::AudioProcessorARAExtension
                             #endif
@@ -279,24 +427,124 @@ public:
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout(); 
     juce::AudioProcessorValueTreeState apvts {*this, nullptr, "Parameters", createParameterLayout()};
 
-    juce::AudioVisualiserComponent waveformViewer;
+    //every parameter by its Params::Id, looked up once here
+    const Params::Handles parameters { apvts };
+
+    //min/max history for the editor's waveform view, filled on the audio thread
+    Dsp::WaveformCapture waveformCapture;
+
+    //BS.1770 loudness and true peak, measured while the meters are subscribed
+    Dsp::LoudnessMeter loudnessMeter;
+
+    //correlation and goniometer points, only measured while the goniometer is showing
+    Dsp::StereoAnalyzer stereoAnalyzer;
+
+   #if COURSEWORK_ENABLE_PROFILER
+    //per stage timing of processBlock, see DSP/Profiler.h
+    Dsp::Profiler profiler;
+   #endif
 
     using BlockType = juce::AudioBuffer<float>;
     SingleChannelSampleFifo<BlockType> leftChannelFifo { Channel::Left };
     SingleChannelSampleFifo<BlockType> rightChannelFifo { Channel::Right };
 
-    float getRmsValue(const int channel) const;
+    //left channel after the filters but before the distortion, for the pre/post overlay
+    SingleChannelSampleFifo<BlockType> preChannelFifo { Channel::Left };
+
+    //editor only, copies the latest meter snapshot, returns false if there's nothing new
+    bool readTelemetry(Dsp::TelemetrySnapshot& dest) { return telemetry.read(dest); }
+
+    //editors subscribe here to switch the capture paths on
+    CaptureRegistry captureRegistry;
+
+    //the quality tier processBlock is running at, and its share of the block's time budget
+    Dsp::QualityTier getQualityTier() const { return qualityGovernor.getTier(); }
+    float getProcessingLoad() const { return qualityGovernor.getLoad(); }
 private:
-    MonoChain leftChain, rightChain;
+    //which streams were fed last block, so a stream that starts again can be reset first
+    std::array<bool, static_cast<size_t>(CaptureStream::NumStreams)> captureActive{};
 
-    void updateLowCutFilters(const ChainSettings& chainSettings);
-    void updateHighCutFilters(const ChainSettings& chainSettings);
+    bool updateCaptureState(CaptureStream stream, bool enabled);
+    void restartCapture(CaptureStream stream);
+
+    //two sets of filters, so a restored state can fade in on one while the old one fades out on the other
+    std::array<MonoChain, 2> leftChains, rightChains;
+    size_t activeChains = 0;
+
+    //these update the active set
+    void updateLowCutFilters(const ChainSettings& chainSettings, const Dsp::ButterworthSections& lowCutCoefficients);
+    void updateHighCutFilters(const ChainSettings& chainSettings, const Dsp::ButterworthSections& highCutCoefficients);
 
     void updateFilters();
+    void updateFilters(const ChainSettings& chainSettings);
+
+    //sum of the filter parameters' versions in this block's snapshot
+    juce::uint32 getFilterVersion() const;
+
+    static void applyShaper(juce::AudioBuffer<float>& buffer, int numChannels, int start, int end, const ShaperSettings& settings, bool fast);
 
     juce::dsp::Oscillator<float> osc;
 
-    juce::LinearSmoothedValue<float> rmsLevelLeft, rmsLevelRight;
+    //steps the quality down when processBlock gets close to its deadline
+    Dsp::QualityGovernor qualityGovernor;
+
+    //audio thread, the parameters as processBlock sees them this block
+    Params::Snapshot parameterSnapshot;
+
+    //the filter parameters' versions the filters were last designed for
+    juce::uint32 designedFilterVersion = 0;
+
+    //restored states and presets on their way to the audio thread. the message thread numbers
+    //each one, and marks it applied once all of its parameters have been written. sequentially
+    //consistent, like the parameters' own atomics, see processBlock()
+    Dsp::TripleBuffer<ProcessingConfig> pendingConfigs;
+    std::atomic<juce::uint32> restoresPublished{ 0 }, restoresApplied{ 0 };
+
+    //message thread, numbers and publishes the config in pendingConfigs' write buffer, returns its number
+    juce::uint32 publishConfig();
+
+    //message thread, a saved ValueTree's parameter values, snapping them to what the parameters
+    //would store, and writing them into the parameters
+    void readParameterValues(const juce::ValueTree& state, std::array<float, Params::NumParameters>& values) const;
+    void snapParameterValues(std::array<float, Params::NumParameters>& values) const;
+    void writeParameterValues(const ProcessingConfig& config);
+
+    //message thread, the factory presets decoded into configs, see setCurrentProgram()
+    std::array<ProcessingConfig, Presets::numPresets> presetConfigs;
+    int currentProgram = 0;
+
+    //audio thread, the last restored state, whether its values still stand in for the parameters,
+    //and whether the filters still have to switch to it
+    ProcessingConfig restoredConfig;
+    bool holdingRestoredValues = false, configSwitchPending = false;
+
+    //audio thread, moves the filters over to a restored state, crossfading if audio is already running
+    void switchToConfig(ProcessingConfig& config);
+
+    static constexpr double configFadeSeconds = 0.02;
+    int configFadeLength = 0, configFadeRemaining = 0;
+    juce::AudioBuffer<float> fadeBuffer;
+    ShaperSettings lastShaperSettings, fadeShaperSettings;
+    bool hasProcessedBlock = false;
+
+    //CCs 20 to 28, see automatedParameters. processBlock is split wherever one lands
+    Dsp::MidiAutomation midiAutomation;
+
+    //applies a CC to the settings, returns false if it was for another stage
+    static bool applyAutomation(ChainSettings& settings, const Dsp::MidiAutomation::Event& event);
+    static bool applyAutomation(ShaperSettings& settings, const Dsp::MidiAutomation::Event& event);
+
+    //passes the tier on to the host's "Quality Tier" parameter, and the CCs on to their parameters
+    void timerCallback() override;
+
+    //written once per block while the meters are subscribed, smoothing is left to the editor
+    Dsp::TripleBuffer<Dsp::TelemetrySnapshot> telemetry;
+    std::array<juce::uint32, Dsp::TelemetrySnapshot::numChannels> clipCounts{}, overCounts{};
+    std::array<int, Dsp::TelemetrySnapshot::numChannels> fullScaleRuns{};
+    juce::uint64 telemetryBlocks = 0;
+
+    using ChannelLevels = std::array<float, Dsp::TelemetrySnapshot::numChannels>;
+    void publishTelemetry(const juce::AudioBuffer<float>& buffer, float drive, const ChannelLevels& inputPeaks, const ChannelLevels& inputRms);
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CourseworkPluginAudioProcessor)
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "Parameters.h"
+
+#include <algorithm>
+#include <array>
+
+/*
+ the factory presets, offered to the host as its programs. a preset only
+ sets the sound: the filters and the distortion. the analyser, the quality
+ mode and the help toggle are left as they are. each preset lists the
+ parameters it changes, the rest of the sound is at its defaults.
+ */
+namespace Presets
+{
+    using Values = std::array<float, Params::NumParameters>;
+
+    struct Preset
+    {
+        const char* name;
+        Values values;
+    };
+
+    //the parameters a preset sets, every other one keeps its value when a preset is loaded
+    inline constexpr std::array<Params::Id, 9> parameters
+    {
+        Params::LowCutFreq, Params::HighCutFreq, Params::LowCutSlope, Params::HighCutSlope,
+        Params::LowCutBypassed, Params::HighCutBypassed, Params::Drive, Params::PostGain, Params::Mix
+    };
+
+    //every parameter at its default, apart from the changes
+    inline Values withChanges(std::initializer_list<std::pair<Params::Id, float>> changes)
+    {
+        Values values;
+        for (const auto& info : Params::table)
+            values[static_cast<size_t>(info.index)] = info.defaultValue;
+
+        for (const auto& change : changes)
+        {
+            jassert(std::find(parameters.begin(), parameters.end(), change.first) != parameters.end());
+            values[static_cast<size_t>(change.first)] = change.second;
+        }
+
+        return values;
+    }
+
+    constexpr int numPresets = 6;
+
+    inline const std::array<Preset, numPresets>& getFactoryPresets()
+    {
+        using namespace Params;
+
+        //slopes are choice indices: 0 is 12 dB/Oct up to 3 for 48 dB/Oct
+        static const std::array<Preset, numPresets> presets
+        {{
+            { "Default",            withChanges({}) },
+            { "Gentle Saturation",  withChanges({ { Drive, 2.f }, { PostGain, -2.f }, { Mix, 0.5f } }) },
+            { "Warm Drive",         withChanges({ { LowCutFreq, 40.f }, { HighCutFreq, 12000.f }, { Drive, 4.f }, { PostGain, -6.f }, { Mix, 0.8f } }) },
+            { "Telephone",          withChanges({ { LowCutFreq, 300.f }, { LowCutSlope, 1.f }, { HighCutFreq, 3400.f }, { HighCutSlope, 1.f },
+                                                  { Drive, 3.f }, { PostGain, -4.f } }) },
+            { "Heavy Fuzz",         withChanges({ { LowCutFreq, 80.f }, { LowCutSlope, 1.f }, { HighCutFreq, 8000.f }, { Drive, 10.f }, { PostGain, -12.f } }) },
+            { "Bass Cut",           withChanges({ { LowCutFreq, 150.f }, { LowCutSlope, 3.f } }) },
+        }};
+
+        return presets;
+    }
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "Parameters.h"
+
+#include <cstring>
+
+/*
+ the binary state getStateInformation() saves: an 8 byte header, then every
+ parameter's plain value as a 32 bit float in Params::table order, all little
+ endian.
+
+     "CWPS"  uint16 version  uint16 number of values  float values...
+
+ parameters are only ever added at the end of the table, so an older blob
+ just has fewer values and the rest keep their defaults. a version this
+ build doesn't know is rejected rather than guessed at. states saved before
+ this format are ValueTrees, setStateInformation() still reads those.
+ */
+namespace StateFormat
+{
+    using Values = std::array<float, Params::NumParameters>;
+
+    //"CWPS" read as a little endian int
+    constexpr juce::uint32 magic = 0x53505743;
+    constexpr juce::uint16 currentVersion = 1;
+    constexpr int headerSize = 8;
+
+    inline void write(const Values& values, juce::MemoryBlock& dest)
+    {
+        juce::MemoryOutputStream stream(dest, true);
+        stream.writeInt(static_cast<int>(magic));
+        stream.writeShort(static_cast<short>(currentVersion));
+        stream.writeShort(static_cast<short>(values.size()));
+
+        for (auto value : values)
+            stream.writeFloat(value);
+    }
+
+    //returns false if the data isn't in this format, or is from a newer version of it
+    inline bool read(const void* data, int sizeInBytes, Values& values)
+    {
+        if (data == nullptr || sizeInBytes < headerSize)
+            return false;
+
+        const auto* bytes = static_cast<const juce::uint8*>(data);
+        if (juce::ByteOrder::littleEndianInt(bytes) != magic)
+            return false;
+
+        const auto version = juce::ByteOrder::littleEndianShort(bytes + 4);
+        const auto numValues = static_cast<int>(juce::ByteOrder::littleEndianShort(bytes + 6));
+
+        if (version == 0 || version > currentVersion || sizeInBytes < headerSize + numValues * 4)
+            return false;
+
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            values[i] = Params::table[i].defaultValue;
+
+            if (static_cast<int>(i) < numValues)
+            {
+                const auto bits = juce::ByteOrder::littleEndianInt(bytes + headerSize + 4 * i);
+
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+
+                if (std::isfinite(value))
+                    values[i] = value;
+            }
+        }
+
+        return true;
+    }
+};